@@ -10,8 +10,12 @@ import sys
 import logging
 import argparse
 import json
+import math
 from pathlib import Path
 
+# Process start, the reference for the startup phase timings
+STARTED = time.monotonic()
+
 # Add src to path
 sys.path.insert(0, str(Path(__file__).parent / 'src'))
 
@@ -23,11 +27,18 @@ logging.basicConfig(
 logger = logging.getLogger(__name__)
 
 from hardware.led_controller import LEDController
-from patterns import PatternRegistry
+from monitoring import MetricsServer
+from control import ControlServer, protocol
+from patterns import PatternRegistry, kernels
+from effects.compositor import LayerStack, check_params
+
+IMPORTED = time.monotonic()
 
 # Constants
 HEALTH_LOG_INTERVAL = 10.0  # Seconds between health logs
 HEALTH_CHECK_INTERVAL = 1.0  # Seconds between health checks
+# Startup milestones, in order, reported as ms since process start
+STARTUP_PHASES = ('imports', 'controller', 'boot_frame', 'patterns', 'first_frame')
 
 
 class MushroomLights:
@@ -35,12 +46,69 @@ class MushroomLights:
     
     def __init__(self, config_path: str = "config/led_config.yaml"):
         logger.info("Starting Mushroom Lights...")
+        self.startup_ms = {'imports': (IMPORTED - STARTED) * 1000}
         
         # Initialize LED controller
         self.controller = LEDController(config_path)
+        self.mark_startup('controller')
+        
+        # Light the LEDs with the last saved look before anything else loads
+        if 'boot' not in self.controller.config:
+            raise ValueError("Config missing 'boot' section")
+        boot_config = self.controller.config['boot']
+        for key in ('frame_file', 'capture_after_s'):
+            if key not in boot_config:
+                raise ValueError(f"Config missing 'boot.{key}'")
+        self.boot_frame_path = None
+        if boot_config['frame_file']:
+            self.boot_frame_path = str(Path(config_path).parent / boot_config['frame_file'])
+            if self.controller.show_boot_frame(self.boot_frame_path):
+                self.mark_startup('boot_frame')
+        self.boot_capture_after = boot_config['capture_after_s']
+        self.boot_capture_at = None
+        for phase in STARTUP_PHASES:
+            self.controller.metrics.gauge('startup_ms', "Milliseconds from process start to each startup phase",
+                                          lambda phase=phase: self.startup_ms[phase] if phase in self.startup_ms else -1,
+                                          phase=phase)
         
         # Pattern registry
         self.registry = PatternRegistry()
+        if 'compiled_kernels' not in self.controller.config['performance']:
+            raise ValueError("Config missing 'performance.compiled_kernels'")
+        kernels.configure(self.controller.config['performance']['compiled_kernels'])
+        
+        # Shared audio capture and analysis, bound to every pattern
+        self.audio_stream = None
+        self.audio_analyzer = None
+        if 'audio' not in self.controller.config or 'enabled' not in self.controller.config['audio']:
+            raise ValueError("Config missing 'audio.enabled'")
+        if self.controller.config['audio']['enabled']:
+            self._init_audio(self.controller.config['audio'])
+        
+        # HTTP metrics endpoint
+        self.metrics_server = None
+        if 'monitoring' not in self.controller.config:
+            raise ValueError("Config missing 'monitoring' section")
+        monitoring_config = self.controller.config['monitoring']
+        for key in ('http_enabled', 'bind', 'port'):
+            if key not in monitoring_config:
+                raise ValueError(f"Config missing 'monitoring.{key}'")
+        if monitoring_config['http_enabled']:
+            self.metrics_server = MetricsServer(self.controller.metrics, monitoring_config['bind'],
+                                                monitoring_config['port'], self._collect_metrics)
+        
+        # Live control socket for external controllers
+        self.control_server = None
+        if 'control' not in self.controller.config or 'enabled' not in self.controller.config['control']:
+            raise ValueError("Config missing 'control.enabled'")
+        if self.controller.config['control']['enabled']:
+            self.control_server = ControlServer(self.controller.config['control'], self._handle_control)
+        
+        # Optional pattern rotation (set_playlist)
+        self.playlist = None
+        self.playlist_zones = {}
+        self.playlist_index = -1
+        self.last_playlist_switch = 0.0
         
         # Control flags
         self.running = True
@@ -51,53 +119,290 @@ class MushroomLights:
         
         logger.info("Mushroom Lights initialized")
     
+    def _init_audio(self, audio_config: dict):
+        """Create the capture stream and its analysis worker"""
+        # Imported here so sounddevice is only needed with audio enabled
+        from audio import AudioDevice, AudioStream, AudioAnalyzer
+        
+        if 'analysis' not in audio_config:
+            raise ValueError("Config missing 'audio.analysis'")
+        
+        device_id = AudioDevice.find_usb_device(audio_config['device'])
+        audio_profile = self.controller.thread_profiles['audio']
+        self.audio_stream = AudioStream(dict(audio_config, device_id=device_id), audio_profile,
+                                        self.controller.metrics)
+        self.audio_analyzer = AudioAnalyzer(self.audio_stream, audio_config['analysis'], audio_profile,
+                                            self.controller.metrics)
+        if self.controller.execution == 'processes':
+            logger.warning("Audio features are not shared with pattern worker processes - "
+                           "audio-reactive patterns need performance.execution: threads")
+    
+    def mark_startup(self, phase: str, at: float = None):
+        """Record a startup phase as finished (now, or at a time.monotonic() value)"""
+        self.startup_ms[phase] = ((at if at is not None else time.monotonic()) - STARTED) * 1000
+        logger.info(f"Startup: {phase} after {self.startup_ms[phase]:.0f}ms")
+    
     def signal_handler(self, sig, frame):
         """Handle shutdown signals"""
         logger.info("Shutdown signal received")
         self.running = False
     
-    def set_patterns(self, cap_pattern_name: str, stem_pattern_name: str) -> bool:
+    def _create_pattern(self, spec, led_count: int):
+        """Pattern from a registry name, or a LayerStack from a list of layer entries"""
+        if isinstance(spec, list):
+            try:
+                return LayerStack.from_config(spec, led_count)
+            except ValueError as e:
+                logger.error(f"Invalid layer stack: {e}")
+                return None
+        return self.registry.create_pattern(spec, led_count)
+    
+    @staticmethod
+    def _pattern_label(spec) -> str:
+        if isinstance(spec, list):
+            return ' + '.join(str(entry.get('pattern')) for entry in spec)
+        return spec
+    
+    def _prepare_pattern(self, spec, led_count: int, geometry):
         """
-        Set patterns for cap and stem
+        Create, bind and prewarm a pattern off the render threads
+        
+        Returns:
+            Ready pattern, or None if it could not be created
+        """
+        pattern = self._create_pattern(spec, led_count)
+        if pattern is None:
+            return None
+        pattern.bind_geometry(geometry)
+        # Worker processes cannot share the analyzer (and it would not pickle for a live switch)
+        if self.audio_analyzer and self.controller.execution == 'threads':
+            pattern.bind_audio(self.audio_analyzer)
+        pattern.prewarm()
+        return pattern
+    
+    def set_patterns(self, specs: dict) -> bool:
+        """
+        Set patterns for the zones
         
         Args:
-            cap_pattern_name: Pattern name for cap LEDs
-            stem_pattern_name: Pattern name for stem LEDs
+            specs: Zone name -> pattern name, or a list of layers (bottom first)
             
         Returns:
-            True if both patterns set successfully
+            True if every pattern set successfully
         """
         success = True
         
-        # Create cap pattern with dynamic LED count from config
-        if cap_pattern_name:
-            cap_pattern = self.registry.create_pattern(cap_pattern_name, self.controller.cap_led_count)
-            if cap_pattern:
-                self.controller.set_cap_pattern(cap_pattern)
-                logger.info(f"Set cap pattern: {cap_pattern_name} ({self.controller.cap_led_count} LEDs)")
-            else:
-                logger.error(f"Failed to create cap pattern: {cap_pattern_name}")
+        for name, spec in specs.items():
+            if name not in self.controller.zones:
+                logger.error(f"Unknown zone '{name}', expected one of {list(self.controller.zones)}")
                 success = False
-        
-        # Create stem pattern with dynamic LED count from config
-        if stem_pattern_name:
-            stem_pattern = self.registry.create_pattern(stem_pattern_name, self.controller.stem_led_count)
-            if stem_pattern:
-                self.controller.set_stem_pattern(stem_pattern)
-                logger.info(f"Set stem pattern: {stem_pattern_name} ({self.controller.stem_led_count} LEDs)")
+                continue
+            
+            # Create pattern with dynamic LED count from config
+            zone = self.controller.zones[name]
+            label = self._pattern_label(spec)
+            pattern = self._prepare_pattern(spec, zone.led_count, zone.geometry)
+            if pattern:
+                self.controller.set_pattern(name, pattern)
+                logger.info(f"Set {name} pattern: {label} ({zone.led_count} LEDs)")
             else:
-                logger.error(f"Failed to create stem pattern: {stem_pattern_name}")
+                logger.error(f"Failed to create {name} pattern: {label}")
                 success = False
         
         return success
     
+    def set_playlist(self, playlist: dict):
+        """
+        Cycle patterns every interval_s, crossfading over crossfade_s
+        
+        Every other key names a zone and lists its pattern names or layer
+        lists; a zone without a list keeps its pattern. The first entries
+        replace the current patterns immediately.
+        """
+        for key in ('interval_s', 'crossfade_s'):
+            if key not in playlist:
+                raise ValueError(f"Startup config missing 'playlist.{key}'")
+        zones = {key: entries for key, entries in playlist.items() if key not in ('interval_s', 'crossfade_s')}
+        for name in zones:
+            if name not in self.controller.zones:
+                raise ValueError(f"Startup playlist names unknown zone '{name}', expected one of {list(self.controller.zones)}")
+        if not any(zones.values()):
+            raise ValueError("Startup playlist needs a list for at least one zone")
+        if playlist['interval_s'] <= playlist['crossfade_s']:
+            raise ValueError("playlist.interval_s must be longer than playlist.crossfade_s")
+        self.playlist = playlist
+        self.playlist_zones = zones
+        self.playlist_index = -1
+        self._advance_playlist()
+    
+    def _advance_playlist(self):
+        """Prepare the next playlist entries and crossfade every listed zone to them"""
+        self.playlist_index += 1
+        self.last_playlist_switch = time.time()
+        for name, entries in self.playlist_zones.items():
+            if not entries:
+                continue
+            zone = self.controller.zones[name]
+            spec = entries[self.playlist_index % len(entries)]
+            pattern = self._prepare_pattern(spec, zone.led_count, zone.geometry)
+            if pattern is None:
+                logger.error(f"Playlist: failed to create {name} pattern {self._pattern_label(spec)}, keeping current")
+                continue
+            self.controller.switch_pattern(name, pattern, self.playlist['crossfade_s'])
+            logger.info(f"Playlist: {name} -> {self._pattern_label(spec)}")
+    
+    def _control_zones(self, zone: str) -> list:
+        """Zones a control command addresses: one by name, or all for ''"""
+        if not zone:
+            return list(self.controller.zones)
+        self.controller.zone(zone)
+        return [zone]
+    
+    def _handle_control(self, command) -> str:
+        """
+        Apply one control socket command (on the control thread)
+        
+        Patterns are built and prewarmed here and params validated here, so
+        the render threads only pick up queued results between frames.
+        Raises ValueError to reject the command.
+        """
+        if isinstance(command, protocol.Ping):
+            reply = f"{len(self.controller.zones)} zones, {self.controller.current_fps:.1f} fps"
+            stalled = self.controller.stalled_chains
+            return f"{reply}, stalled: {', '.join(stalled)}" if stalled else reply
+        
+        zones = self._control_zones(command.zone)
+        if isinstance(command, protocol.Brightness):
+            if not command.zone:
+                self.controller.set_brightness(command.brightness)
+            else:
+                self.controller.set_zone_brightness(command.zone, command.brightness)
+            return f"brightness {command.brightness} on {', '.join(zones)}"
+        
+        if self.controller.ingest:
+            raise ValueError("Patterns are not used while pixel ingest is enabled")
+        
+        if isinstance(command, protocol.Params):
+            # Check every zone first so a rejected command changes nothing; a
+            # value that fails here would otherwise fail every frame
+            for name in zones:
+                pattern = self.controller.zones[name].pattern
+                if pattern is None:
+                    raise ValueError(f"{name} has no pattern")
+                try:
+                    check_params(pattern, command.params)
+                except ValueError as e:
+                    raise ValueError(f"{name}: {e}") from e
+            for name in zones:
+                self.controller.set_params(name, command.params)
+            return f"{len(command.params)} params on {', '.join(zones)}"
+        
+        if command.pattern not in self.registry.list_patterns():
+            raise ValueError(f"Unknown pattern '{command.pattern}'")
+        if not math.isfinite(command.crossfade) or command.crossfade < 0:
+            raise ValueError(f"Crossfade must be finite and non-negative, got {command.crossfade}")
+        prepared = {}
+        for name in zones:
+            zone = self.controller.zones[name]
+            prepared[name] = self._prepare_pattern(command.pattern, zone.led_count, zone.geometry)
+            if prepared[name] is None:
+                raise ValueError(f"Failed to create {name} pattern {command.pattern}")
+        if self.playlist:
+            # A look picked live stays put until the next restart
+            logger.info("Control: pattern switch stops the playlist")
+            self.playlist = None
+        for name, pattern in prepared.items():
+            self.controller.switch_pattern(name, pattern, command.crossfade)
+        return f"{command.pattern} on {', '.join(zones)}"
+    
+    def _collect_metrics(self) -> dict:
+        """Metrics document for the JSON file and the /metrics.json endpoint"""
+        stats = self.controller.get_stats()
+        zones = {}
+        for name, zone in self.controller.zones.items():
+            zone_stats = stats['zones'][name]
+            zones[name] = {
+                'led_count': zone.led_count,
+                'pattern': zone.pattern.__class__.__name__ if zone.pattern else None,
+                'generation_ms': zone_stats['generation_ms'],
+                'dropped': zone_stats['dropped'],
+                'repeated': zone_stats['repeated'],
+                'errors': zone_stats['errors'],
+                'quality': zone_stats['quality'],
+                'frames_missed': zone_stats['frames_missed'],
+                'output_ratio': zone_stats['output_ratio']
+            }
+        
+        metrics = {
+            'timestamp': time.time(),
+            'fps': self.controller.current_fps,
+            'frames_sent': self.controller.frames_sent,
+            'stalled_chains': self.controller.stalled_chains,
+            'chains': stats['chains'],
+            'zones': zones,
+            'frame_handoff': {
+                'unchanged_skipped': stats['frames_skipped']
+            },
+            'timing_ms': {
+                'buffer_prep': self.controller.last_buffer_prep_ms,
+                'spi_transmit': self.controller.last_spi_transmit_ms
+            },
+            'latency_ms': self.controller.metrics.summaries(),
+            'metrics_window_seconds': self.controller.metrics.window_seconds,
+            'audio': self._audio_metrics(),
+            'startup_ms': dict(self.startup_ms),
+            'scheduling_ms': {
+                'spi_wakeup_mean': stats['spi_wakeup_mean_ms'],
+                'spi_wakeup_max': stats['spi_wakeup_max_ms'],
+                'pattern_wakeup_mean': stats['pattern_wakeup_mean_ms'],
+                'pattern_wakeup_max': stats['pattern_wakeup_max_ms']
+            }
+        }
+        if 'ingest' in stats:
+            metrics['ingest'] = stats['ingest']
+        if 'power' in stats:
+            metrics['power'] = stats['power']
+        return metrics
+    
+    def _audio_metrics(self) -> dict:
+        """Capture and analysis health for the metrics file"""
+        if not self.audio_analyzer:
+            return {'enabled': False}
+        status = self.audio_stream.get_status()
+        return {
+            'enabled': True,
+            'active': status.is_active,
+            'rms': self.audio_analyzer.features.rms,
+            'onsets': self.audio_analyzer.features.onsets,
+            'input_overflows': status.input_overflows,
+            'ring_overruns': status.ring_overruns,
+            'hops_skipped': self.audio_analyzer.hops_skipped,
+            'analysis_ms': self.audio_analyzer.last_analysis_ms
+        }
+    
     def run(self):
         """Main application loop - monitors health"""
         logger.info("Starting LED controller threads...")
         
-        # Start the controller (starts all threads)
+        # Start the controller first: in process execution it forks the pattern
+        # workers, which should not inherit running audio threads
         self.controller.start()
         
+        if self.audio_stream:
+            if self.audio_stream.start():
+                self.audio_analyzer.start()
+            else:
+                logger.warning("Audio capture failed to start - audio-reactive patterns will see silence")
+        
+        if self.metrics_server:
+            self.metrics_server.start()
+        if self.control_server:
+            self.control_server.start()
+        
+        # Save the running look as the next boot frame once it has settled
+        if self.boot_frame_path and self.boot_capture_after > 0 and self.controller.frame_buffer is not None:
+            self.boot_capture_at = time.monotonic() + self.boot_capture_after
+        
         # Health monitoring
         last_health_log = time.time()
         last_health_check = time.time()
@@ -112,78 +417,49 @@ class MushroomLights:
                 if current_time - last_health_check >= HEALTH_CHECK_INTERVAL:
                     health = self.controller.get_health()
                     
-                    # Check for thread failures
-                    cap_health = health['cap']
-                    stem_health = health['stem']
-                    
-                    if not cap_health['pattern_alive'] or not cap_health['spi_alive']:
-                        logger.error("Cap controller thread died!")
-                        self.running = False
-                        break
-                    
-                    if not stem_health['pattern_alive'] or not stem_health['spi_alive']:
-                        logger.error("Stem controller thread died!")
-                        self.running = False
-                        break
-                    
-                    # Check for excessive errors
-                    if cap_health['pattern_errors'] >= 3 or cap_health['spi_errors'] >= 3:
-                        logger.error("Cap controller has too many errors!")
-                        self.running = False
-                        break
-                    
-                    if stem_health['pattern_errors'] >= 3 or stem_health['spi_errors'] >= 3:
-                        logger.error("Stem controller has too many errors!")
-                        self.running = False
+                    # Check for thread failures and excessive errors
+                    max_errors = self.controller.max_consecutive_errors
+                    for name, zone_health in health['zones'].items():
+                        if not zone_health['pattern_alive'] or not zone_health['spi_alive']:
+                            logger.error(f"{name} controller thread died!")
+                            self.running = False
+                            break
+                        if zone_health['pattern_errors'] >= max_errors or zone_health['spi_errors'] >= max_errors:
+                            logger.error(f"{name} controller has too many errors!")
+                            self.running = False
+                            break
+                    if not self.running:
                         break
                     
                     last_health_check = current_time
                 
+                if 'first_frame' not in self.startup_ms and self.controller.first_frame_at is not None:
+                    self.mark_startup('first_frame', self.controller.first_frame_at)
+                if self.boot_capture_at is not None and time.monotonic() >= self.boot_capture_at:
+                    self.boot_capture_at = None
+                    try:
+                        self.controller.save_boot_frame(self.boot_frame_path)
+                    except OSError as e:
+                        logger.warning(f"Could not save boot frame: {e}")
+                
+                # Rotate patterns; the new ones are built here, not on the render threads
+                if self.playlist and current_time - self.last_playlist_switch >= self.playlist['interval_s']:
+                    self._advance_playlist()
+                
                 # Log performance periodically
                 if current_time - last_health_log >= HEALTH_LOG_INTERVAL:
                     stats = self.controller.get_stats()
-                    # With serialized SPI, both strips run at same effective rate
-                    effective_fps = min(stats['cap_fps'], stats['stem_fps']) if stats['cap_fps'] > 0 and stats['stem_fps'] > 0 else max(stats['cap_fps'], stats['stem_fps'])
+                    # Chains share a frame barrier, so every zone runs at the same rate
                     logger.info(
-                        f"Performance | FPS: {effective_fps:.1f} | "
-                        f"Frames: {stats['cap_frames'] + stats['stem_frames']} | "
-                        f"Errors: {stats['cap_errors'] + stats['stem_errors']}"
+                        f"Performance | FPS: {stats['fps']:.1f} | "
+                        f"Frames: {stats['frames']} | "
+                        f"Errors: {stats['errors']}"
                     )
                     
                     # Export performance metrics to JSON
                     try:
-                        # Get pattern names safely
-                        cap_pattern_name = None
-                        stem_pattern_name = None
-                        
-                        if hasattr(self.controller, 'cap_pattern') and self.controller.cap_pattern:
-                            cap_pattern_name = self.controller.cap_pattern.__class__.__name__
-                        
-                        if hasattr(self.controller, 'stem_pattern') and self.controller.stem_pattern:
-                            stem_pattern_name = self.controller.stem_pattern.__class__.__name__
-                        
-                        metrics = {
-                            'timestamp': current_time,
-                            'fps': self.controller.current_fps,
-                            'frames_sent': self.controller.frames_sent,
-                            'led_counts': {
-                                'cap': self.controller.cap_led_count,
-                                'stem': self.controller.stem_led_count
-                            },
-                            'patterns': {
-                                'cap': cap_pattern_name,
-                                'stem': stem_pattern_name
-                            },
-                            'timing_ms': {
-                                'pattern_wait': self.controller.last_pattern_wait_ms,
-                                'buffer_prep': self.controller.last_buffer_prep_ms,
-                                'spi_transmit': self.controller.last_spi_transmit_ms,
-                                'cap_generation': self.controller.last_cap_generation_ms,
-                                'stem_generation': self.controller.last_stem_generation_ms
-                            }
-                        }
                         with open('/tmp/mushroom-metrics.json', 'w') as f:
-                            json.dump(metrics, f, indent=2)
+                            json.dump(self._collect_metrics(), f, indent=2)
                     except Exception as e:
                         logger.debug(f"Failed to export metrics: {e}")
                     
@@ -198,10 +474,24 @@ class MushroomLights:
         finally:
             # Clean shutdown
             logger.info("Shutting down...")
+            if self.metrics_server:
+                self.metrics_server.stop()
+            if self.control_server:
+                self.control_server.stop()
             self.controller.cleanup()
+            if self.audio_stream:
+                self.audio_analyzer.stop()
+                self.audio_stream.stop()
             logger.info("Shutdown complete")
 
 
+def parse_zone_value(value: str):
+    """ZONE=VALUE from the command line"""
+    if '=' not in value:
+        raise argparse.ArgumentTypeError(f"Expected ZONE=VALUE, got '{value}'")
+    return tuple(value.split('=', 1))
+
+
 def main():
     """Entry point"""
     # Get available patterns from registry
@@ -209,22 +499,18 @@ def main():
     
     parser = argparse.ArgumentParser(description='Mushroom LED Controller')
     parser.add_argument(
-        '--cap-pattern',
-        default=None,
-        choices=available_patterns if available_patterns else None,
-        help='Pattern for cap LEDs'
-    )
-    parser.add_argument(
-        '--stem-pattern',
-        default=None,
-        choices=available_patterns if available_patterns else None,
-        help='Pattern for stem LEDs'
+        '--zone-pattern',
+        type=parse_zone_value,
+        action='append',
+        default=[],
+        metavar='ZONE=PATTERN',
+        help='Pattern for one zone, e.g. cap=rainbow (repeatable)'
     )
     parser.add_argument(
         '--pattern', '-p',
         default=None,
         choices=available_patterns if available_patterns else None,
-        help='Pattern for both cap and stem (overrides individual patterns)'
+        help='Pattern for every zone (overrides individual patterns)'
     )
     parser.add_argument(
         '--config', '-c',
@@ -238,16 +524,12 @@ def main():
         help='Global brightness 0-255'
     )
     parser.add_argument(
-        '--cap-brightness',
-        type=int,
-        default=None,
-        help='Cap brightness 0-255'
-    )
-    parser.add_argument(
-        '--stem-brightness',
-        type=int,
-        default=None,
-        help='Stem brightness 0-255'
+        '--zone-brightness',
+        type=parse_zone_value,
+        action='append',
+        default=[],
+        metavar='ZONE=N',
+        help='Brightness 0-255 for one zone, e.g. stem=96 (repeatable)'
     )
     parser.add_argument(
         '--startup-config', '-s',
@@ -273,74 +555,84 @@ def main():
             print(pattern)
         sys.exit(0)
     
-    # Determine patterns to use
-    cap_pattern = None
-    stem_pattern = None
-    brightness = 128
-    cap_brightness = None
-    stem_brightness = None
+    for _, pattern in args.zone_pattern:
+        if pattern not in available_patterns:
+            parser.error(f"Unknown pattern '{pattern}' (available: {', '.join(available_patterns)})")
+    zone_brightness = {}
+    for zone, value in args.zone_brightness:
+        try:
+            zone_brightness[zone] = int(value)
+        except ValueError:
+            parser.error(f"Brightness for zone '{zone}' must be an integer, got '{value}'")
     
     # Load startup configuration if it exists and not disabled
+    startup = {}
     if not args.no_startup_config and Path(args.startup_config).exists():
         try:
             import yaml
             with open(args.startup_config, 'r') as f:
-                startup = yaml.safe_load(f)
-                cap_pattern = startup.get('cap_pattern', 'rainbow')
-                stem_pattern = startup.get('stem_pattern', 'rainbow')
-                brightness = startup.get('brightness', 128)
-                cap_brightness = startup.get('cap_brightness')
-                stem_brightness = startup.get('stem_brightness')
+                startup = yaml.safe_load(f) or {}
                 logger.info(f"Loaded startup config from {args.startup_config}")
         except Exception as e:
             logger.warning(f"Could not load startup config: {e}")
+    brightness = startup.get('brightness', 128)
+    playlist = startup.get('playlist')
+    
+    # Create and configure application
+    app = MushroomLights(args.config)
+    zone_names = list(app.controller.zones)
+    for zone in [zone for zone, _ in args.zone_pattern] + list(zone_brightness):
+        if zone not in zone_names:
+            logger.error(f"Unknown zone '{zone}', expected one of {zone_names}")
+            sys.exit(1)
+    
+    # Startup config keys per zone: <zone>_pattern, <zone>_layers (replaces the
+    # single pattern) and <zone>_brightness
+    patterns = {}
+    for zone in zone_names:
+        patterns[zone] = startup.get(f'{zone}_layers') or startup.get(f'{zone}_pattern', 'rainbow')
+        if f'{zone}_brightness' in startup:
+            zone_brightness.setdefault(zone, startup[f'{zone}_brightness'])
     
     # Command line arguments override startup config
+    if args.pattern or args.zone_pattern:
+        # Patterns chosen on the command line stay put
+        playlist = None
     if args.pattern:
-        # Same pattern for both
-        cap_pattern = args.pattern
-        stem_pattern = args.pattern
+        # Same pattern for every zone
+        patterns = {zone: args.pattern for zone in zone_names}
     else:
         # Individual patterns
-        if args.cap_pattern:
-            cap_pattern = args.cap_pattern
-        if args.stem_pattern:
-            stem_pattern = args.stem_pattern
+        patterns.update(dict(args.zone_pattern))
     
     # Default patterns if none specified
-    if not cap_pattern:
-        cap_pattern = 'rainbow'
-        logger.info(f"No cap pattern specified, using default: {cap_pattern}")
-    if not stem_pattern:
-        stem_pattern = 'rainbow'
-        logger.info(f"No stem pattern specified, using default: {stem_pattern}")
+    for zone in zone_names:
+        if not patterns[zone]:
+            patterns[zone] = 'rainbow'
+            logger.info(f"No {zone} pattern specified, using default: {patterns[zone]}")
     
     # Brightness overrides
     if args.brightness is not None:
         brightness = args.brightness
-    if args.cap_brightness is not None:
-        cap_brightness = args.cap_brightness
-    if args.stem_brightness is not None:
-        stem_brightness = args.stem_brightness
     
-    # Create and configure application
-    app = MushroomLights(args.config)
-    
-    # Set patterns
-    if not app.set_patterns(cap_pattern, stem_pattern):
-        logger.error("Failed to set patterns")
-        sys.exit(1)
+    # Set patterns (ingest mode shows network frames instead)
+    if app.controller.ingest:
+        logger.info(f"Pixel ingest enabled ({app.controller.ingest.protocol}), patterns and playlist unused")
+    else:
+        if not app.set_patterns(patterns):
+            logger.error("Failed to set patterns")
+            sys.exit(1)
+        if playlist:
+            app.set_playlist(playlist)
+        app.mark_startup('patterns')
     
     # Set brightness
     if brightness is not None:
         app.controller.set_brightness(brightness)
         logger.info(f"Set global brightness to {brightness}")
-    if cap_brightness is not None:
-        app.controller.set_cap_brightness(cap_brightness)
-        logger.info(f"Set cap brightness to {cap_brightness}")
-    if stem_brightness is not None:
-        app.controller.set_stem_brightness(stem_brightness)
-        logger.info(f"Set stem brightness to {stem_brightness}")
+    for zone, value in zone_brightness.items():
+        app.controller.set_zone_brightness(zone, value)
+        logger.info(f"Set {zone} brightness to {value}")
     
     # Run
     app.run()
@@ -44,8 +44,7 @@ cmd_start() {
     
     # Parse arguments using array for safety
     PATTERN=""
-    CAP_PATTERN=""
-    STEM_PATTERN=""
+    ZONE_PATTERNS=()
     BRIGHTNESS=""
     ARGS=()
     
@@ -61,19 +60,14 @@ cmd_start() {
                 ARGS+=("--pattern" "$2")
                 shift 2
                 ;;
-            --cap-pattern)
-                CAP_PATTERN="$2"
-                ARGS+=("--cap-pattern" "$2")
-                shift 2
-                ;;
-            --stem-pattern)
-                STEM_PATTERN="$2"
-                ARGS+=("--stem-pattern" "$2")
+            --zone-pattern)
+                ZONE_PATTERNS+=("$2")
+                ARGS+=("--zone-pattern" "$2")
                 shift 2
                 ;;
             *)
-                # First non-flag argument is pattern for both
-                if [ -z "$PATTERN" ] && [ -z "$CAP_PATTERN" ] && [ -z "$STEM_PATTERN" ]; then
+                # First non-flag argument is pattern for every zone
+                if [ -z "$PATTERN" ] && [ ${#ZONE_PATTERNS[@]} -eq 0 ]; then
                     PATTERN="$1"
                     ARGS+=("--pattern" "$1")
                 fi
@@ -84,14 +78,11 @@ cmd_start() {
     
     echo "Starting LED controller..."
     if [ -n "$PATTERN" ]; then
-        echo "  Pattern (both): $PATTERN"
-    fi
-    if [ -n "$CAP_PATTERN" ]; then
-        echo "  Cap pattern: $CAP_PATTERN"
-    fi
-    if [ -n "$STEM_PATTERN" ]; then
-        echo "  Stem pattern: $STEM_PATTERN"
+        echo "  Pattern (all zones): $PATTERN"
     fi
+    for ZONE_PATTERN in "${ZONE_PATTERNS[@]}"; do
+        echo "  Zone pattern: $ZONE_PATTERN"
+    done
     if [ -n "$BRIGHTNESS" ]; then
         echo "  Brightness: $BRIGHTNESS"
     fi
@@ -317,15 +308,14 @@ if [ $# -eq 0 ]; then
     echo "  perf              View performance metrics"
     echo ""
     echo "Start Options:"
-    echo "  [pattern]                    Set same pattern for both strips"
-    echo "  --pattern PATTERN            Set same pattern for both strips"
-    echo "  --cap-pattern PATTERN        Set pattern for cap (450 LEDs)"
-    echo "  --stem-pattern PATTERN       Set pattern for stem (250 LEDs)"
+    echo "  [pattern]                    Set same pattern for every zone"
+    echo "  --pattern PATTERN            Set same pattern for every zone"
+    echo "  --zone-pattern ZONE=PATTERN  Set pattern for one zone (repeatable)"
     echo "  --brightness N               Set global brightness (0-255)"
     echo ""
     echo "Examples:"
-    echo "  ./run.sh start rainbow                    # Both strips rainbow"
-    echo "  ./run.sh start --cap-pattern rainbow --stem-pattern test"
+    echo "  ./run.sh start rainbow                    # Every zone rainbow"
+    echo "  ./run.sh start --zone-pattern cap=rainbow --zone-pattern stem=test"
     echo "  ./run.sh start --brightness 128"
     echo "  ./run.sh status"
     echo ""
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Bake a pattern to a frame file for the playback pattern
+
+Usage:
+    python3 scripts/bake_pattern.py rainbow --zone cap --seconds 30 -o shows/rainbow_cap.mshf
+    python3 scripts/bake_pattern.py rainbow --led-count 450 --fps 60 --param rainbow_count=1.0 -o rainbow.mshf
+
+Then play it with a startup layer:
+    cap_layers:
+      - pattern: playback
+        params: {file: shows/rainbow_cap.mshf}
+"""
+
+import argparse
+import sys
+import time
+from pathlib import Path
+
+import yaml
+
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from effects.frame_file import ENCODINGS, FrameFile, bake_pattern
+from effects.geometry import Geometry
+from hardware.zone import zone_name
+from patterns import PatternRegistry, kernels
+
+
+def parse_param(value: str):
+    """name=value, with the value parsed as YAML (numbers, booleans, strings)"""
+    if '=' not in value:
+        raise argparse.ArgumentTypeError(f"Expected name=value, got '{value}'")
+    name, raw = value.split('=', 1)
+    return name, yaml.safe_load(raw)
+
+
+def main():
+    available = PatternRegistry().list_patterns()
+
+    parser = argparse.ArgumentParser(description='Record a pattern to a frame file')
+    parser.add_argument('pattern', choices=available, help='Pattern to record')
+    parser.add_argument('--output', '-o', required=True, help='Frame file to write')
+    parser.add_argument('--zone', default=None,
+                        help='Take LED count and layout from this zone (strip name) in the config')
+    parser.add_argument('--led-count', type=int, default=None, help='LED count (straight line layout)')
+    parser.add_argument('--config', '-c', default='config/led_config.yaml', help='LED config for --zone')
+    parser.add_argument('--seconds', type=float, default=30.0, help='Length to record (loops seamlessly '
+                        'when it is a whole number of the pattern\'s cycles)')
+    parser.add_argument('--fps', type=float, default=60.0, help='Recorded frame rate')
+    parser.add_argument('--encoding', choices=list(ENCODINGS), default='delta',
+                        help='raw (largest, no decode) or delta (changed LEDs only)')
+    parser.add_argument('--param', type=parse_param, action='append', default=[],
+                        help='Pattern parameter as name=value (repeatable)')
+    args = parser.parse_args()
+
+    if (args.zone is None) == (args.led_count is None):
+        parser.error("Give exactly one of --zone or --led-count")
+
+    if args.zone:
+        with open(args.config, 'r') as f:
+            config = yaml.safe_load(f)
+        strips = {zone_name(strip): strip for strip in config['strips']}
+        if args.zone not in strips:
+            parser.error(f"Unknown zone '{args.zone}', expected one of {list(strips)}")
+        strip = strips[args.zone]
+        led_count = strip['led_count']
+        geometry = Geometry.from_config(strip, Path(args.config).parent)
+        kernels.configure(config['performance']['compiled_kernels'])
+    else:
+        led_count = args.led_count
+        geometry = Geometry.line(led_count)
+
+    pattern = PatternRegistry.create_pattern(args.pattern, led_count)
+    pattern.bind_geometry(geometry)
+    for name, value in args.param:
+        pattern.set_param(name, value)
+    pattern.prewarm()
+
+    start = time.perf_counter()
+    frames = bake_pattern(pattern, args.output, args.seconds, args.fps, args.encoding)
+    elapsed = time.perf_counter() - start
+
+    size = Path(args.output).stat().st_size
+    raw_size = frames * led_count * 3
+    baked = FrameFile(args.output)
+    print(f"{args.output}: {frames} frames x {led_count} LEDs at {args.fps:g} FPS "
+          f"({baked.duration:.1f}s), {baked.encoding}")
+    print(f"  {size / 1024:.1f} KiB ({size / raw_size * 100:.0f}% of raw), "
+          f"rendered in {elapsed:.2f}s ({frames / elapsed:.0f} FPS)")
+
+
+if __name__ == '__main__':
+    main()
@@ -7,23 +7,37 @@ import json
 import time
 import sys
 import os
+import urllib.request
 
-def main():
-    metrics_file = '/tmp/mushroom-metrics.json'
-    
-    # Check if metrics file exists
-    if not os.path.exists(metrics_file):
-        print("No metrics available")
-        print("Start the controller first with:")
-        print("  ./run.sh start")
-        sys.exit(1)
-    
+METRICS_URL = 'http://127.0.0.1:9105/metrics.json'  # monitoring.port in led_config.yaml
+METRICS_FILE = '/tmp/mushroom-metrics.json'
+
+
+def fetch_live():
+    """Current metrics from the controller's endpoint, or None if it is not serving"""
     try:
-        with open(metrics_file, 'r') as f:
-            data = json.load(f)
-    except (json.JSONDecodeError, IOError) as e:
-        print(f"Error reading metrics: {e}")
-        sys.exit(1)
+        with urllib.request.urlopen(METRICS_URL, timeout=0.5) as response:
+            return json.load(response)
+    except (OSError, ValueError):
+        return None
+
+
+def main():
+    data = fetch_live()
+    if data is None:
+        # Fall back to the file written every health-log interval
+        if not os.path.exists(METRICS_FILE):
+            print("No metrics available")
+            print("Start the controller first with:")
+            print("  ./run.sh start")
+            sys.exit(1)
+        
+        try:
+            with open(METRICS_FILE, 'r') as f:
+                data = json.load(f)
+        except (json.JSONDecodeError, IOError) as e:
+            print(f"Error reading metrics: {e}")
+            sys.exit(1)
     
     # Validate required fields exist
     if 'timestamp' not in data:
@@ -36,19 +50,21 @@ def main():
     print('=== Performance Metrics ===')
     print(f'Data age: {age} seconds ago\n')
     
-    # Display patterns if available
-    if 'patterns' in data and 'led_counts' in data:
-        for strip in ['cap', 'stem']:
-            if strip in data['patterns'] and strip in data['led_counts']:
-                pattern = data['patterns'][strip]
-                led_count = data['led_counts'][strip]
-                print(f'{strip.upper()} ({led_count} LEDs, {pattern} pattern)')
+    # Display zones if available
+    zones = data['zones'] if 'zones' in data else {}
+    if zones:
+        for name, zone in zones.items():
+            print(f'{name.upper()} ({zone["led_count"]} LEDs, {zone["pattern"]} pattern)')
         print()
     
     # Display FPS if available  
     if 'fps' in data and 'frames_sent' in data:
         print(f'FPS: {data["fps"]:.1f}')
         print(f'Frames sent: {data["frames_sent"]}')
+        if 'chains' in data and len(data['chains']) > 1:
+            # FPS above is the slowest chain
+            for device, chain in data['chains'].items():
+                print(f'  {device}: {chain["fps"]:.1f} FPS ({chain["transmit_fps"]:.1f} sent), {chain["frames"]} frames')
     else:
         print('Performance data not yet available')
     
@@ -57,8 +73,8 @@ def main():
         print()
         print('Timing breakdown (last frame):')
         timing = data['timing_ms']
-        if 'pattern_wait' in timing:
-            print(f'  Pattern wait: {timing["pattern_wait"]:.1f}ms')
+        for name, zone in zones.items():
+            print(f'  {name.capitalize() + " pattern:":<14}{zone["generation_ms"]:.1f}ms')
         if 'buffer_prep' in timing:
             print(f'  Buffer prep:  {timing["buffer_prep"]:.1f}ms')
         if 'spi_transmit' in timing:
@@ -67,6 +83,84 @@ def main():
         if 'buffer_prep' in timing and 'spi_transmit' in timing:
             total_ms = timing['buffer_prep'] + timing['spi_transmit']
             print(f'  Total frame:  {total_ms:.1f}ms')
+    
+    # Display latency histograms if available
+    if 'latency_ms' in data:
+        window = data['metrics_window_seconds'] if 'metrics_window_seconds' in data else 0
+        print()
+        print(f'Stage latency, last {window:g}s (p50 / p99 / max):')
+        for stage, series in sorted(data['latency_ms'].items()):
+            for label, summary in sorted(series.items()):
+                if summary['count'] == 0:
+                    continue
+                name = stage if label == 'all' else f'{stage} [{label}]'
+                print(f'  {name:<40} {summary["p50"]:7.2f} / {summary["p99"]:7.2f} / {summary["max"]:7.2f}ms')
+    
+    # Display triple-buffer handoff counters if available
+    if 'frame_handoff' in data:
+        print()
+        print('Frame handoff (since start):')
+        handoff = data['frame_handoff']
+        for name, zone in zones.items():
+            print(f'  {name.capitalize():<8} dropped: {zone["dropped"]}, repeated: {zone["repeated"]}')
+        if 'unchanged_skipped' in handoff:
+            print(f'  Unchanged frames not resent: {handoff["unchanged_skipped"]}')
+
+    # Display power limiting if enabled
+    if 'power' in data:
+        print()
+        print('Power (estimated amps / budget):')
+        for rail, power in data['power'].items():
+            print(f'  {rail:<8} {power["amps"]:5.1f}A / {power["budget_amps"]:.1f}A '
+                  f'(asked {power["demand_amps"]:.1f}A, scale {power["scale"]:.2f}, '
+                  f'{power["frames_limited"]} frames limited)')
+
+    # Display network pixel ingest if enabled
+    if 'ingest' in data:
+        ingest = data['ingest']
+        print()
+        print(f'Ingest ({ingest["protocol"]}): {ingest["frames"]} frames from {ingest["packets"]} packets')
+        print(f'  Partial frames: {ingest["partial_frames"]}, out of sequence: {ingest["dropped"]}, '
+              f'ignored: {ingest["ignored"]}')
+
+    # Display startup phases (ms after process start)
+    if 'startup_ms' in data:
+        print()
+        print('Startup: ' + ', '.join(f'{phase} {ms:.0f}ms' for phase, ms in data['startup_ms'].items()))
+
+    # Display audio analysis health if enabled
+    if 'audio' in data and data['audio']['enabled']:
+        audio = data['audio']
+        print()
+        print(f'Audio: {"active" if audio["active"] else "inactive"}, RMS {audio["rms"]:.2f}, '
+              f'{audio["onsets"]} onsets, analysis {audio["analysis_ms"]:.2f}ms')
+        print(f'  Input overflows: {audio["input_overflows"]}, ring overruns: {audio["ring_overruns"]}, '
+              f'hops skipped: {audio["hops_skipped"]}')
+    
+    # Display scheduling latency if available
+    if 'scheduling_ms' in data:
+        print()
+        print('Wakeup latency (mean / recent max):')
+        sched = data['scheduling_ms']
+        for thread in ['spi', 'pattern']:
+            if f'{thread}_wakeup_mean' in sched and f'{thread}_wakeup_max' in sched:
+                print(f'  {thread.upper() if thread == "spi" else thread.capitalize():<8} '
+                      f'{sched[f"{thread}_wakeup_mean"]:.3f}ms / {sched[f"{thread}_wakeup_max"]:.3f}ms')
+
+    if zones:
+        print()
+        print('Render quality (1.00 = full detail):')
+        for name, zone in zones.items():
+            print(f'  {name.capitalize():<8} {zone["quality"]:.2f}  '
+                  f'({zone["frames_missed"]} frame deadlines missed)')
+
+    interpolated = {name: zone for name, zone in zones.items()
+                    if 'output_ratio' in zone and zone['output_ratio'] is not None}
+    if interpolated:
+        print()
+        print('Interpolation (frames sent per frame rendered):')
+        for name, zone in interpolated.items():
+            print(f'  {name.capitalize():<8} {zone["output_ratio"]:.2f}x')
 
 if __name__ == '__main__':
     main()
\ No newline at end of file
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Send live control commands to a running controller (control.enabled)
+
+Usage:
+    python3 scripts/mushroom_ctl.py brightness 96
+    python3 scripts/mushroom_ctl.py --zone stem brightness 64
+    python3 scripts/mushroom_ctl.py --zone cap param cycle_time=10 saturation=0.8
+    python3 scripts/mushroom_ctl.py --zone cap pattern wisps --crossfade 2
+    python3 scripts/mushroom_ctl.py --unix /tmp/mushroom-control.sock ping
+
+Without --zone a command applies to every zone.
+"""
+
+import argparse
+import os
+import socket
+import sys
+import tempfile
+from pathlib import Path
+
+import yaml
+
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from control import protocol
+
+
+def parse_param(value: str):
+    """name=value, with the value parsed as YAML (numbers, booleans, strings)"""
+    if '=' not in value:
+        raise argparse.ArgumentTypeError(f"Expected name=value, got '{value}'")
+    name, raw = value.split('=', 1)
+    return name, yaml.safe_load(raw)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Live control of the mushroom lights')
+    parser.add_argument('--host', default='127.0.0.1', help='Controller address (udp transport)')
+    parser.add_argument('--port', type=int, default=9106, help='control.port (udp transport)')
+    parser.add_argument('--unix', default=None, metavar='PATH', help='control.path (unix transport)')
+    parser.add_argument('--zone', default='', help='Zone name (default: every zone)')
+    parser.add_argument('--timeout', type=float, default=2.0, help='Seconds to wait for the reply')
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    commands.add_parser('ping', help='Check the controller is listening')
+    brightness = commands.add_parser('brightness', help='Set brightness 0-255')
+    brightness.add_argument('value', type=int)
+    param = commands.add_parser('param', help='Set pattern params (N.name for layer N of a stack)')
+    param.add_argument('params', type=parse_param, nargs='+', metavar='NAME=VALUE')
+    pattern = commands.add_parser('pattern', help='Crossfade to a pattern')
+    pattern.add_argument('name')
+    pattern.add_argument('--crossfade', type=float, default=3.0, help='Seconds (0 cuts)')
+
+    args = parser.parse_args()
+
+    if args.command == 'ping':
+        command = protocol.Ping()
+    elif args.command == 'brightness':
+        if not 0 <= args.value <= 255:
+            parser.error(f"Brightness must be 0-255, got {args.value}")
+        command = protocol.Brightness(args.zone, args.value)
+    elif args.command == 'param':
+        command = protocol.Params(args.zone, dict(args.params))
+    else:
+        command = protocol.Pattern(args.zone, args.name, args.crossfade)
+    request_id = os.getpid() & 0xFFFF
+    try:
+        packet = protocol.encode(command, request_id)
+    except ValueError as e:
+        parser.error(str(e))
+
+    reply_path = None
+    if args.unix:
+        # Datagram replies need an address of our own to come back to
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+        reply_path = os.path.join(tempfile.gettempdir(), f"mushroom-ctl-{os.getpid()}.sock")
+        sock.bind(reply_path)
+        target = args.unix
+    else:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        target = (args.host, args.port)
+    sock.settimeout(args.timeout)
+
+    try:
+        sock.sendto(packet, target)
+        while True:
+            reply_id, status, message = protocol.decode_reply(sock.recv(protocol.MAX_REPLY))
+            if reply_id == request_id:
+                break
+    except socket.timeout:
+        print(f"No reply within {args.timeout}s (is control.enabled set?)", file=sys.stderr)
+        sys.exit(2)
+    except (OSError, ValueError) as e:
+        print(f"Control request failed: {e}", file=sys.stderr)
+        sys.exit(2)
+    finally:
+        sock.close()
+        if reply_path:
+            os.unlink(reply_path)
+
+    if status != protocol.OK:
+        print(f"Rejected: {message}", file=sys.stderr)
+        sys.exit(1)
+    print(message)
+
+
+if __name__ == '__main__':
+    main()
@@ -5,6 +5,8 @@ Audio Module - Audio capture and processing for LED patterns
 
 from .device import AudioDevice
 from .stream import AudioStream
+from .ring_buffer import RingBuffer
+from .analysis import AudioAnalyzer, AudioFeatures
 from .utils import (
     get_volume,
     get_peak,
@@ -17,6 +19,9 @@ from .utils import (
 __all__ = [
     'AudioDevice', 
     'AudioStream',
+    'RingBuffer',
+    'AudioAnalyzer',
+    'AudioFeatures',
     'get_volume',
     'get_peak',
     'get_frequency_bands',
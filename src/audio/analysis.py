@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""
+Audio Analysis - Streaming FFT feature extraction shared by all patterns
+One worker runs a Hann-windowed real FFT over the capture ring once per hop
+and publishes an immutable AudioFeatures snapshot that patterns read lock-free
+"""
+
+import logging
+import threading
+import time
+from dataclasses import dataclass
+import numpy as np
+from .stream import AudioStream
+
+logger = logging.getLogger(__name__)
+
+# Band energies map dBFS onto 0-1 with this floor
+BAND_FLOOR_DB = -60.0
+# Onsets need at least this much spectral flux, so silence noise never triggers
+MIN_ONSET_FLUX = 0.01
+
+
+@dataclass(frozen=True)
+class AudioFeatures:
+    """Features of one analysis hop; replaced, never modified"""
+    timestamp: float     # time.time() when published
+    position: int        # Ring sample position at the end of the window
+    level: float         # 0-1 RMS of the latest hop
+    rms: float           # 0-1 RMS with fast attack and slow release
+    bands: np.ndarray    # Read-only 0-1 log-spaced band energies, low to high
+    flux: float          # Positive spectral flux of the latest hop
+    onset: bool          # This hop is an onset
+    onsets: int          # Onsets so far; compare with the last value seen to catch every beat
+
+
+class AudioAnalyzer:
+    """Background worker turning the capture ring into AudioFeatures snapshots"""
+
+    def __init__(self, stream: AudioStream, config: dict, thread_profile=None, metrics=None):
+        """
+        Args:
+            stream: Started or not-yet-started capture stream to analyze
+            config: Dictionary with analysis settings
+            thread_profile: Optional realtime ThreadProfile for the worker
+            metrics: Optional MetricsRegistry for the per-hop analysis histogram
+        """
+        self.stream = stream
+        self.ring = stream.ring
+        self.sample_rate = stream.sample_rate
+        self.thread_profile = thread_profile
+
+        # Configuration
+        for key in ('fft_size', 'hop_size', 'bands', 'min_freq', 'max_freq', 'onset_threshold',
+                    'onset_cooldown_s', 'rms_attack', 'rms_release'):
+            if key not in config:
+                raise ValueError(f"Config missing 'audio.analysis.{key}'")
+        self.fft_size = config['fft_size']
+        self.hop_size = config['hop_size']
+        self.band_count = config['bands']
+        self.min_freq = config['min_freq']
+        self.max_freq = config['max_freq']
+        self.onset_threshold = config['onset_threshold']
+        self.onset_cooldown = int(config['onset_cooldown_s'] * self.sample_rate)
+        self.rms_attack = config['rms_attack']
+        self.rms_release = config['rms_release']
+
+        if self.fft_size > self.ring.capacity:
+            raise ValueError(f"FFT size {self.fft_size} exceeds audio ring of {self.ring.capacity} samples")
+        if not 0 < self.hop_size <= self.fft_size:
+            raise ValueError(f"Hop size must be 1-{self.fft_size}, got {self.hop_size}")
+
+        # Window, normalized so a full-scale sine reads as magnitude 1
+        self._window = np.hanning(self.fft_size).astype(np.float32)
+        self._magnitude_scale = 2.0 / float(self._window.sum())
+        self._band_starts, self._band_stop = self._band_edges()
+
+        # Per-hop scratch
+        bins = self.fft_size // 2 + 1
+        self._frame = np.zeros(self.fft_size, dtype=np.float32)
+        self._magnitude = np.zeros(bins, dtype=np.float64)
+        self._log_magnitude = np.zeros(bins, dtype=np.float64)
+        self._previous_log = np.zeros(bins, dtype=np.float64)
+        self._diff = np.zeros(bins, dtype=np.float64)
+
+        # Detector state
+        self._flux_mean = 0.0
+        self._rms = 0.0
+        self._onsets = 0
+        self._last_onset = -self.onset_cooldown
+
+        # Published snapshot - a single reference swap, so readers never lock
+        self.features = AudioFeatures(
+            timestamp=time.time(), position=0, level=0.0, rms=0.0,
+            bands=self._freeze(np.zeros(self.band_count)), flux=0.0, onset=False, onsets=0
+        )
+
+        # Statistics
+        self.hops_analyzed = 0
+        self.hops_skipped = 0
+        self.last_analysis_ms = 0
+        self.analysis_histogram = None
+        if metrics is not None:
+            self.analysis_histogram = metrics.histogram('audio_analysis_ms', "FFT feature extraction time per hop")
+
+        self.running = False
+        self.thread = None
+
+        logger.info(f"Audio analysis: {self.fft_size}-point FFT every {self.hop_size} samples "
+                    f"({self.hop_size / self.sample_rate * 1000:.1f}ms), {self.band_count} bands "
+                    f"{self.min_freq:.0f}-{self.max_freq:.0f}Hz")
+
+    def _band_edges(self):
+        """FFT bin index where each log-spaced band starts, plus the end of the last band"""
+        bin_hz = self.sample_rate / self.fft_size
+        bins = self.fft_size // 2 + 1
+        edges = np.rint(np.geomspace(self.min_freq, self.max_freq, self.band_count + 1) / bin_hz).astype(np.intp)
+        # Low bands narrower than a bin still get one bin each
+        for i in range(1, edges.size):
+            edges[i] = max(edges[i], edges[i - 1] + 1)
+        if edges[0] < 1 or edges[-1] > bins:
+            raise ValueError(f"{self.band_count} bands from {self.min_freq}-{self.max_freq}Hz do not fit "
+                             f"a {self.fft_size}-point FFT at {self.sample_rate}Hz")
+        return edges[:-1], int(edges[-1])
+
+    @staticmethod
+    def _freeze(array: np.ndarray) -> np.ndarray:
+        array.setflags(write=False)
+        return array
+
+    def start(self):
+        """Start the analysis worker"""
+        if self.running:
+            return
+        self.running = True
+        self.thread = threading.Thread(target=self._run, daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        """Stop the analysis worker"""
+        self.running = False
+        if self.thread and self.thread.is_alive():
+            self.thread.join(timeout=1.0)
+
+    def _run(self):
+        if self.thread_profile is not None:
+            self.thread_profile.apply()
+        logger.debug("Audio analysis thread started")
+
+        next_end = self.fft_size
+        while self.running:
+            head = self.ring.head
+            if head < next_end:
+                time.sleep((next_end - head) / self.sample_rate)
+                continue
+
+            # Fell more than a window behind: jump to the newest hop instead of catching up
+            if head - next_end >= self.fft_size:
+                skipped = (head - next_end) // self.hop_size
+                self.hops_skipped += skipped
+                next_end += skipped * self.hop_size
+
+            end = next_end
+            next_end += self.hop_size
+            window = self.ring.window(end, self.fft_size)
+            if window is None:
+                continue
+
+            try:
+                analysis_start = time.time()
+                self.features = self._analyze(window, end)
+                self.hops_analyzed += 1
+                self.last_analysis_ms = (time.time() - analysis_start) * 1000
+                if self.analysis_histogram is not None:
+                    self.analysis_histogram.record(self.last_analysis_ms)
+            except Exception as e:
+                logger.error(f"Audio analysis error: {e}")
+                time.sleep(0.1)
+
+        logger.debug("Audio analysis thread exited")
+
+    def _analyze(self, window: np.ndarray, end: int) -> AudioFeatures:
+        """Compute one hop's features from the fft_size samples ending at end"""
+        hop = window[-self.hop_size:]
+        level = min(1.0, float(np.sqrt(np.dot(hop, hop) / self.hop_size)))
+        coefficient = self.rms_attack if level > self._rms else self.rms_release
+        self._rms = coefficient * self._rms + (1.0 - coefficient) * level
+
+        np.multiply(window, self._window, out=self._frame)
+        magnitude = self._magnitude
+        np.abs(np.fft.rfft(self._frame), out=magnitude)
+        magnitude *= self._magnitude_scale
+
+        # Band energy in dBFS, mapped onto 0-1
+        power = np.square(magnitude[:self._band_stop])
+        band_power = np.add.reduceat(power, self._band_starts)
+        bands = np.log10(band_power + 1e-12)
+        bands *= 10.0 / -BAND_FLOOR_DB
+        bands += 1.0
+        np.clip(bands, 0.0, 1.0, out=bands)
+
+        # Half-wave rectified change in log magnitude
+        np.multiply(magnitude, 100.0, out=self._log_magnitude)
+        np.log1p(self._log_magnitude, out=self._log_magnitude)
+        np.subtract(self._log_magnitude, self._previous_log, out=self._diff)
+        np.maximum(self._diff, 0.0, out=self._diff)
+        flux = float(self._diff.mean())
+        self._log_magnitude, self._previous_log = self._previous_log, self._log_magnitude
+
+        # Onset when flux jumps well above its running mean
+        onset = (flux > self._flux_mean * self.onset_threshold and flux > MIN_ONSET_FLUX
+                 and end - self._last_onset >= self.onset_cooldown)
+        if onset:
+            self._onsets += 1
+            self._last_onset = end
+        self._flux_mean = 0.9 * self._flux_mean + 0.1 * flux
+
+        return AudioFeatures(
+            timestamp=time.time(),
+            position=end,
+            level=level,
+            rms=self._rms,
+            bands=self._freeze(bands),
+            flux=flux,
+            onset=onset,
+            onsets=self._onsets
+        )
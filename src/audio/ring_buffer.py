@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+Ring Buffer - Lock-free single-producer/single-consumer audio sample ring
+Every sample is stored twice (at i and i + capacity) so the last N samples
+are always one contiguous slice, readable as a zero-copy view
+"""
+
+import numpy as np
+from typing import Optional
+
+
+class RingBuffer:
+    """Mirrored float32 ring written by the audio callback, read by analysis and patterns"""
+
+    def __init__(self, capacity: int):
+        if capacity <= 0:
+            raise ValueError(f"Ring capacity must be positive, got {capacity}")
+
+        self.capacity = capacity
+        self._data = np.zeros(2 * capacity, dtype=np.float32)
+
+        # Total samples ever written; only the producer advances it, after the data lands
+        self.head = 0
+
+        # Samples that arrived in one block larger than the whole ring
+        self.samples_overwritten = 0
+        # Windows a consumer asked for after the producer had already overwritten them
+        self.overruns = 0
+
+    def write(self, samples: np.ndarray, gain: float = 1.0):
+        """
+        Append samples, scaled by gain and clipped to -1..1
+
+        Producer side only (the audio callback thread).
+        """
+        count = samples.shape[0]
+        capacity = self.capacity
+        if count > capacity:
+            self.samples_overwritten += count - capacity
+            samples = samples[count - capacity:]
+            count = capacity
+
+        start = self.head % capacity
+        first = min(count, capacity - start)
+        self._store(samples[:first], start, gain)
+        if first < count:
+            self._store(samples[first:], 0, gain)
+        self.head += count
+
+    def _store(self, samples: np.ndarray, start: int, gain: float):
+        end = start + samples.shape[0]
+        primary = self._data[start:end]
+        np.multiply(samples, gain, out=primary)
+        np.clip(primary, -1.0, 1.0, out=primary)
+        self._data[start + self.capacity:end + self.capacity] = primary
+
+    def latest(self, count: int) -> np.ndarray:
+        """Zero-copy view of the most recent count samples, oldest first"""
+        if not 0 < count <= self.capacity:
+            raise ValueError(f"Can read 1-{self.capacity} samples, got {count}")
+        end = self.head % self.capacity + self.capacity
+        return self._data[end - count:end]
+
+    def window(self, end: int, count: int) -> Optional[np.ndarray]:
+        """
+        Zero-copy view of count samples ending at absolute sample position end
+
+        Returns:
+            The view, or None if those samples are not written yet or have
+            already been overwritten (counted as an overrun)
+        """
+        if not 0 < count <= self.capacity:
+            raise ValueError(f"Can read 1-{self.capacity} samples, got {count}")
+        head = self.head
+        if end > head:
+            return None
+        if head - end + count > self.capacity:
+            self.overruns += 1
+            return None
+        stop = end % self.capacity + self.capacity
+        return self._data[stop - count:stop]
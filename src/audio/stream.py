@@ -1,14 +1,15 @@
 #!/usr/bin/env python3
 """
-Audio Stream - Simple wrapper around sounddevice for audio capture
+Audio Stream - Callback-mode sounddevice capture into a lock-free ring buffer
 """
 
 import sounddevice as sd
 import numpy as np
 import logging
 import time
-from typing import Optional, Tuple
+from typing import Optional
 from dataclasses import dataclass
+from .ring_buffer import RingBuffer
 
 logger = logging.getLogger(__name__)
 
@@ -24,23 +25,34 @@ class AudioStatus:
     peak_level: float     # 0-1 peak
     frames_read: int      # Total frames read
     uptime: float        # Seconds since started
+    input_overflows: int  # Callbacks where PortAudio dropped input
+    ring_overruns: int    # Reads of samples the callback had already overwritten
 
 
 class AudioStream:
-    """Simple audio capture using sounddevice's internal buffering"""
+    """Audio capture where the PortAudio callback writes straight into a ring buffer"""
     
-    def __init__(self, config: dict):
+    def __init__(self, config: dict, thread_profile=None, metrics=None):
         """
         Initialize audio stream
         
         Args:
             config: Dictionary with audio settings
+            thread_profile: Optional realtime ThreadProfile for the callback thread
+            metrics: Optional MetricsRegistry for the callback interval histogram
         """
         # Configuration
         self.sample_rate = config.get('sample_rate', 44100)
-        self.buffer_size = config.get('buffer_size', 512)
+        self.buffer_size = config.get('buffer_size', 64)
         self.device_id = config.get('device_id', None)
         self.gain = config.get('gain', 1.0)  # Software gain multiplier
+        if 'ring_seconds' not in config:
+            raise ValueError("Config missing 'audio.ring_seconds'")
+        self.ring_seconds = config['ring_seconds']
+        self.thread_profile = thread_profile
+        
+        # Samples land here from the callback; readers take views of it
+        self.ring = RingBuffer(max(self.buffer_size, int(self.sample_rate * self.ring_seconds)))
         
         # Signal monitoring
         self.current_level = 0.0
@@ -48,17 +60,25 @@ class AudioStream:
         self.peak_decay = 0.95
         
         # Statistics
-        self.frames_read = 0
+        self.input_overflows = 0
         self.start_time = None
-        
-        # Cache for last valid audio
-        self.last_audio = np.zeros(self.buffer_size, dtype=np.float32)
+        self._profile_applied = False
+        self._last_callback = None
+        self.callback_histogram = None
+        if metrics is not None:
+            self.callback_histogram = metrics.histogram(
+                'audio_callback_interval_ms', "Time between audio capture callbacks")
         
         # Stream handle
         self.stream = None
         self.device_info = {}
         
-        logger.info(f"Audio stream configured: {self.sample_rate}Hz, {self.buffer_size} samples")
+        logger.info(f"Audio stream configured: {self.sample_rate}Hz, {self.buffer_size} samples, "
+                    f"{self.ring.capacity} sample ring")
+    
+    @property
+    def frames_read(self) -> int:
+        return self.ring.head
     
     def start(self) -> bool:
         """
@@ -74,78 +94,68 @@ class AudioStream:
             else:
                 self.device_info = sd.query_devices(kind='input')
             
-            # Create stream WITHOUT callback (uses internal buffering)
             self.stream = sd.InputStream(
                 device=self.device_id,
                 channels=1,
                 samplerate=self.sample_rate,
                 blocksize=self.buffer_size,
-                dtype=np.float32
+                dtype=np.float32,
+                latency='low',
+                callback=self._callback
             )
             
             self.stream.start()
             self.start_time = time.time()
             
-            logger.info(f"Audio stream started on '{self.device_info['name']}'")
+            logger.info(f"Audio stream started on '{self.device_info['name']}' "
+                        f"(input latency {self.stream.latency * 1000:.1f}ms)")
             return True
             
         except Exception as e:
             logger.error(f"Failed to start audio stream: {e}")
             return False
     
+    def _callback(self, indata: np.ndarray, frames: int, time_info, status):
+        """PortAudio callback thread: append the block and update level meters"""
+        if not self._profile_applied:
+            self._profile_applied = True
+            if self.thread_profile is not None:
+                self.thread_profile.apply()
+        
+        if status.input_overflow:
+            self.input_overflows += 1
+        
+        if self.callback_histogram is not None:
+            now = time.perf_counter()
+            if self._last_callback is not None:
+                self.callback_histogram.record((now - self._last_callback) * 1000)
+            self._last_callback = now
+        
+        self.ring.write(indata[:, 0], self.gain)
+        
+        # Levels from the gained, clipped samples now in the ring
+        block = self.ring.latest(frames)
+        self.current_level = float(np.sqrt(np.dot(block, block) / frames))
+        peak = max(float(block.max()), -float(block.min()))
+        self.peak_level = max(peak, self.peak_level * self.peak_decay)
+    
+    def latest(self, count: int) -> np.ndarray:
+        """
+        Zero-copy view of the most recent count samples (up to the ring size)
+        
+        The view aliases the ring, so copy it if it must outlive the next
+        ring's worth of audio.
+        """
+        return self.ring.latest(count)
+    
     def read_latest(self) -> Optional[np.ndarray]:
         """
-        Non-blocking read of latest audio data
+        Latest buffer_size samples as a zero-copy view
         
         Returns:
-            Audio data or None if no new data
+            Audio data (silence until the stream has started)
         """
-        if not self.stream or not self.stream.active:
-            return self.last_audio
-        
-        try:
-            # Non-blocking read - get available data
-            available = self.stream.read_available
-            if available > 0:
-                # Read available frames (may be more or less than buffer_size)
-                audio_data, overflowed = self.stream.read(available)
-                
-                if overflowed:
-                    logger.debug("Audio buffer overflow detected")
-                
-                # Flatten to mono if needed
-                if audio_data.ndim > 1:
-                    audio_data = audio_data[:, 0]
-                
-                # Apply gain if needed
-                if self.gain != 1.0:
-                    audio_data = np.clip(audio_data * self.gain, -1.0, 1.0)
-                
-                # Update statistics
-                self.frames_read += len(audio_data)
-                
-                # Calculate signal levels (after gain)
-                self.current_level = float(np.sqrt(np.mean(audio_data**2)))
-                peak = float(np.max(np.abs(audio_data)))
-                self.peak_level = max(peak, self.peak_level * self.peak_decay)
-                
-                # Cache the audio
-                if len(audio_data) >= self.buffer_size:
-                    # Take last buffer_size samples if we got more
-                    self.last_audio = audio_data[-self.buffer_size:].copy()
-                else:
-                    # Pad with zeros if we got less
-                    self.last_audio[:len(audio_data)] = audio_data
-                    self.last_audio[len(audio_data):] = 0
-                
-                return self.last_audio
-            else:
-                # No new data available, return cached
-                return self.last_audio
-                
-        except Exception as e:
-            logger.error(f"Error reading audio stream: {e}")
-            return self.last_audio
+        return self.ring.latest(self.buffer_size)
     
     def stop(self):
         """Stop audio stream"""
@@ -171,7 +181,9 @@ class AudioStream:
             current_level=self.current_level,
             peak_level=self.peak_level,
             frames_read=self.frames_read,
-            uptime=time.time() - self.start_time if self.start_time else 0
+            uptime=time.time() - self.start_time if self.start_time else 0,
+            input_overflows=self.input_overflows,
+            ring_overruns=self.ring.overruns
         )
     
     def reset_peak(self):
@@ -0,0 +1,12 @@
+#!/usr/bin/env python3
+"""
+Control Module - Live pattern, param and brightness changes over a datagram socket
+"""
+
+from .server import ControlServer
+from . import protocol
+
+__all__ = [
+    'ControlServer',
+    'protocol'
+]
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""
+Control Protocol - Compact binary datagrams for live pattern, param and brightness changes
+One command per datagram: a fixed header, then length-prefixed UTF-8 strings
+and tagged values, so any controller can build packets without a text parser.
+
+    header:  magic 'MC', version, opcode, request id (uint16, echoed in the reply)
+    string:  uint8 length, UTF-8 bytes
+    value:   tag 'f' float64 | 'i' int64 | 't' bool (uint8) | 's' string
+    integers are big-endian
+
+    BRIGHTNESS  zone, uint8 brightness
+    PARAMS      zone, uint8 count, count * (name, value)
+    PATTERN     zone, pattern name, float32 crossfade seconds
+    PING        (nothing)
+
+An empty zone name addresses every zone. Replies carry the request's
+header with REPLY set in the opcode, then uint8 status (OK or ERROR) and
+a string message.
+"""
+
+import math
+import struct
+from typing import Any, Dict, NamedTuple, Tuple, Union
+
+MAGIC = b'MC'
+VERSION = 1
+HEADER = struct.Struct('!2sBBH')
+
+OP_PING = 0
+OP_BRIGHTNESS = 1
+OP_PARAMS = 2
+OP_PATTERN = 3
+REPLY = 0x80
+
+OK = 0
+ERROR = 1
+
+# Largest reply: header, status and a full-length message
+MAX_REPLY = HEADER.size + 1 + 256
+
+_UINT8 = struct.Struct('!B')
+_FLOAT32 = struct.Struct('!f')
+_VALUES = {b'f': struct.Struct('!d'), b'i': struct.Struct('!q'), b't': _UINT8}
+
+
+class Ping(NamedTuple):
+    pass
+
+
+class Brightness(NamedTuple):
+    zone: str
+    brightness: int
+
+
+class Params(NamedTuple):
+    zone: str
+    params: Dict[str, Any]
+
+
+class Pattern(NamedTuple):
+    zone: str
+    pattern: str
+    crossfade: float
+
+
+Command = Union[Ping, Brightness, Params, Pattern]
+
+
+class _Reader:
+    """Cursor over one datagram; raises ValueError on truncation"""
+
+    def __init__(self, data: bytes, offset: int):
+        self.data = data
+        self.offset = offset
+
+    def unpack(self, layout: struct.Struct) -> Tuple:
+        if self.offset + layout.size > len(self.data):
+            raise ValueError("Truncated control packet")
+        values = layout.unpack_from(self.data, self.offset)
+        self.offset += layout.size
+        return values
+
+    def string(self) -> str:
+        (length,) = self.unpack(_UINT8)
+        if self.offset + length > len(self.data):
+            raise ValueError("Truncated control packet")
+        text = self.data[self.offset:self.offset + length].decode('utf-8')
+        self.offset += length
+        return text
+
+    def value(self) -> Any:
+        if self.offset >= len(self.data):
+            raise ValueError("Truncated control packet")
+        tag = self.data[self.offset:self.offset + 1]
+        self.offset += 1
+        if tag == b's':
+            return self.string()
+        if tag not in _VALUES:
+            raise ValueError(f"Unknown value tag {tag!r}")
+        (value,) = self.unpack(_VALUES[tag])
+        if tag == b'f' and not math.isfinite(value):
+            raise ValueError(f"Control values must be finite, got {value}")
+        return bool(value) if tag == b't' else value
+
+
+def _string(text: str) -> bytes:
+    encoded = text.encode('utf-8')
+    if len(encoded) > 255:
+        raise ValueError(f"String too long for a control packet: {text[:32]}...")
+    return _UINT8.pack(len(encoded)) + encoded
+
+
+def _value(value: Any) -> bytes:
+    if isinstance(value, bool):
+        return b't' + _UINT8.pack(value)
+    if isinstance(value, int):
+        return b'i' + _VALUES[b'i'].pack(value)
+    if isinstance(value, float):
+        return b'f' + _VALUES[b'f'].pack(value)
+    if isinstance(value, str):
+        return b's' + _string(value)
+    raise ValueError(f"Control params must be bool, int, float or str, got {type(value).__name__}")
+
+
+def encode(command: Command, request_id: int = 0) -> bytes:
+    """Datagram for a command"""
+    if isinstance(command, Ping):
+        return HEADER.pack(MAGIC, VERSION, OP_PING, request_id)
+    if isinstance(command, Brightness):
+        return (HEADER.pack(MAGIC, VERSION, OP_BRIGHTNESS, request_id) + _string(command.zone)
+                + _UINT8.pack(command.brightness))
+    if isinstance(command, Params):
+        if len(command.params) > 255:
+            raise ValueError("At most 255 params per control packet")
+        body = b''.join(_string(name) + _value(value) for name, value in command.params.items())
+        return (HEADER.pack(MAGIC, VERSION, OP_PARAMS, request_id) + _string(command.zone)
+                + _UINT8.pack(len(command.params)) + body)
+    if isinstance(command, Pattern):
+        return (HEADER.pack(MAGIC, VERSION, OP_PATTERN, request_id) + _string(command.zone)
+                + _string(command.pattern) + _FLOAT32.pack(command.crossfade))
+    raise ValueError(f"Not a control command: {command!r}")
+
+
+def decode(data: bytes) -> Tuple[int, Command]:
+    """
+    Parse a command datagram
+
+    Returns:
+        Tuple of (request id, command)
+
+    Raises:
+        ValueError: Malformed packet, unknown version or opcode
+    """
+    if len(data) < HEADER.size:
+        raise ValueError("Control packet shorter than its header")
+    magic, version, opcode, request_id = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError("Not a control packet")
+    if version != VERSION:
+        raise ValueError(f"Unsupported control protocol version {version}")
+
+    reader = _Reader(data, HEADER.size)
+    if opcode == OP_PING:
+        command = Ping()
+    elif opcode == OP_BRIGHTNESS:
+        zone = reader.string()
+        (brightness,) = reader.unpack(_UINT8)
+        command = Brightness(zone, brightness)
+    elif opcode == OP_PARAMS:
+        zone = reader.string()
+        (count,) = reader.unpack(_UINT8)
+        params = {}
+        for _ in range(count):
+            name = reader.string()
+            params[name] = reader.value()
+        command = Params(zone, params)
+    elif opcode == OP_PATTERN:
+        zone = reader.string()
+        pattern = reader.string()
+        (crossfade,) = reader.unpack(_FLOAT32)
+        if not math.isfinite(crossfade):
+            raise ValueError(f"Crossfade must be finite, got {crossfade}")
+        command = Pattern(zone, pattern, crossfade)
+    else:
+        raise ValueError(f"Unknown control opcode {opcode}")
+    if reader.offset != len(data):
+        raise ValueError("Trailing bytes after control command")
+    return request_id, command
+
+
+def encode_reply(opcode: int, request_id: int, status: int, message: str = '') -> bytes:
+    """Reply datagram; message is cut to the 255 bytes a string can carry"""
+    message = message.encode('utf-8')[:255].decode('utf-8', 'ignore')
+    return HEADER.pack(MAGIC, VERSION, opcode | REPLY, request_id) + _UINT8.pack(status) + _string(message)
+
+
+def decode_reply(data: bytes) -> Tuple[int, int, str]:
+    """
+    Returns:
+        Tuple of (request id, status, message)
+    """
+    if len(data) < HEADER.size:
+        raise ValueError("Control reply shorter than its header")
+    magic, version, opcode, request_id = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION or not opcode & REPLY:
+        raise ValueError("Not a control reply")
+    reader = _Reader(data, HEADER.size)
+    (status,) = reader.unpack(_UINT8)
+    return request_id, status, reader.string()
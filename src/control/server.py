@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Control Server - Datagram socket for live changes from an external controller or phone
+Decodes protocol commands on its own thread and hands them to a handler, so
+packet parsing and pattern construction never run on the render or SPI threads
+"""
+
+import logging
+import os
+import socket
+import threading
+from typing import Any, Callable, Dict, Optional
+from . import protocol
+
+logger = logging.getLogger(__name__)
+
+MAX_DATAGRAM = 65535
+
+
+class ControlServer:
+    """
+    Serves control commands over UDP or a Unix datagram socket
+
+    Each datagram is one command; the handler applies it and returns a
+    message, or raises ValueError to reject it. Every command is answered
+    with a reply datagram to its sender (Unix clients must bind their own
+    socket path to receive it).
+    """
+
+    def __init__(self, config: Dict[str, Any], handler: Callable[[protocol.Command], str]):
+        """
+        Args:
+            config: The control section of led_config.yaml
+            handler: Applies one decoded command; returns the reply message
+        """
+        for key in ('transport', 'bind', 'port', 'path'):
+            if key not in config:
+                raise ValueError(f"Config missing 'control.{key}'")
+        self.transport = config['transport']
+        if self.transport not in ('udp', 'unix'):
+            raise ValueError(f"control.transport must be 'udp' or 'unix', got '{self.transport}'")
+        self.handler = handler
+
+        if self.transport == 'udp':
+            self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            self.socket.bind((config['bind'], config['port']))
+            self.address = f"udp://{config['bind']}:{config['port']}"
+            self.path = None
+        else:
+            self.path = config['path']
+            if os.path.exists(self.path):
+                # Left behind by an unclean exit
+                os.unlink(self.path)
+            self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+            self.socket.bind(self.path)
+            self.address = f"unix://{self.path}"
+        # Wake up regularly to notice stop()
+        self.socket.settimeout(0.5)
+
+        self.running = False
+        self.thread: Optional[threading.Thread] = None
+        self.commands_applied = 0
+        self.commands_rejected = 0
+        logger.info(f"Control socket on {self.address}")
+
+    def start(self):
+        """Start serving in the background"""
+        self.running = True
+        self.thread = threading.Thread(target=self._serve, name="control", daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        """Stop serving and close the socket"""
+        self.running = False
+        if self.thread is not None:
+            self.thread.join(timeout=1.0)
+            self.thread = None
+        self.socket.close()
+        if self.path and os.path.exists(self.path):
+            os.unlink(self.path)
+
+    def _serve(self):
+        while self.running:
+            try:
+                data, sender = self.socket.recvfrom(MAX_DATAGRAM)
+            except socket.timeout:
+                continue
+            except OSError as e:
+                if self.running:
+                    logger.error(f"Control socket error: {e}")
+                break
+            reply = self._apply(data)
+            if reply is not None and sender:
+                try:
+                    self.socket.sendto(reply, sender)
+                except OSError as e:
+                    logger.debug(f"Control reply to {sender} failed: {e}")
+
+    def _apply(self, data: bytes) -> Optional[bytes]:
+        """Decode and apply one datagram; returns the reply, or None for foreign packets"""
+        if len(data) < protocol.HEADER.size or data[:2] != protocol.MAGIC:
+            self.commands_rejected += 1
+            return None
+        _, _, opcode, request_id = protocol.HEADER.unpack_from(data)
+        try:
+            _, command = protocol.decode(data)
+            message = self.handler(command)
+        except ValueError as e:
+            self.commands_rejected += 1
+            logger.warning(f"Control command rejected: {e}")
+            return protocol.encode_reply(opcode, request_id, protocol.ERROR, str(e))
+        except Exception as e:
+            self.commands_rejected += 1
+            logger.error(f"Control command failed: {e}")
+            return protocol.encode_reply(opcode, request_id, protocol.ERROR, str(e))
+        self.commands_applied += 1
+        return protocol.encode_reply(opcode, request_id, protocol.OK, message)
@@ -4,8 +4,7 @@ Color utilities and predefined palettes for the mushroom
 """
 
 import numpy as np
-import cv2
-from typing import Tuple, List
+from typing import Tuple, List, Optional, Sequence, Union
 
 
 # Mushroom-inspired color palettes (from research document)
@@ -55,17 +54,42 @@ def interpolate_color(color1: Tuple[int, int, int],
     Linearly interpolate between two colors
     t: 0.0 = color1, 1.0 = color2
     """
-    t = np.clip(t, 0.0, 1.0)
+    t = min(max(t, 0.0), 1.0)
     r = int(color1[0] * (1 - t) + color2[0] * t)
     g = int(color1[1] * (1 - t) + color2[1] * t)
     b = int(color1[2] * (1 - t) + color2[2] * t)
     return (r, g, b)
 
 
+def interpolate_stops(colors: Sequence[Tuple[int, int, int]], count: int, wrap: bool) -> np.ndarray:
+    """
+    count colors evenly through the stops, linearly interpolated and rounded
+    
+    wrap ends the last segment back at the first stop, so entry count would
+    equal entry 0; otherwise the first and last entries are the end stops.
+    """
+    stops = np.asarray(colors, dtype=np.float32)
+    if stops.ndim != 2 or stops.shape[1] != 3 or len(stops) < 2:
+        raise ValueError(f"Palette needs at least 2 RGB colors, got {len(stops)}")
+    if wrap:
+        stops = np.concatenate((stops, stops[:1]))
+        at = np.arange(count, dtype=np.float32) * ((len(stops) - 1) / count)
+    else:
+        at = np.linspace(0.0, len(stops) - 1, count, dtype=np.float32)
+    
+    segment = np.minimum(at.astype(np.intp), len(stops) - 2)
+    t = (at - segment)[:, None]
+    colors = stops[segment] + (stops[segment + 1] - stops[segment]) * t
+    return np.clip(colors + 0.5, 0, 255).astype(np.uint8)
+
+
 def gradient(colors: List[Tuple[int, int, int]], 
             led_count: int) -> np.ndarray:
     """
     Create a smooth gradient across LEDs using multiple colors
+    
+    One vectorized pass; the first LED is the first color and the last LED
+    the last. For traveling or repeated palettes use effects.palette.
     """
     if len(colors) < 2:
         raise ValueError("Need at least 2 colors for gradient")
@@ -74,26 +98,11 @@ def gradient(colors: List[Tuple[int, int, int]],
     if led_count <= 0:
         return np.zeros((0, 3), dtype=np.uint8)
     
-    result = np.zeros((led_count, 3), dtype=np.uint8)
-    
     # Special case: single LED
     if led_count == 1:
-        result[0] = colors[0]
-        return result
-    
-    # Divide LEDs into segments
-    segment_size = led_count / (len(colors) - 1)
+        return np.array([colors[0]], dtype=np.uint8)
     
-    for i in range(led_count):
-        # Find which segment we're in
-        segment = min(int(i / segment_size), len(colors) - 2)
-        local_pos = (i - segment * segment_size) / segment_size
-        
-        # Interpolate between segment colors
-        color = interpolate_color(colors[segment], colors[segment + 1], local_pos)
-        result[i] = color
-    
-    return result
+    return interpolate_stops(colors, led_count, wrap=False)
 
 
 def apply_brightness(pixels: np.ndarray, brightness: float) -> np.ndarray:
@@ -114,38 +123,52 @@ def fade(pixels: np.ndarray, fade_amount: float) -> np.ndarray:
     return (pixels * (1.0 - fade_amount)).astype(np.uint8)
 
 
-def hsv_to_rgb(h: np.ndarray, s: float = 1.0, v: float = 1.0) -> np.ndarray:
+def hsv_to_rgb(h: np.ndarray,
+               s: Union[float, np.ndarray] = 1.0,
+               v: Union[float, np.ndarray] = 1.0,
+               out: Optional[np.ndarray] = None) -> np.ndarray:
     """
-    Convert HSV to RGB using OpenCV for optimal performance
+    Convert HSV to RGB in one vectorized pass at full hue precision
+    
+    Uses the closed form channel = v - v*s*clamp(min(k, 4-k), 0, 1) with
+    k = (n + h/60) mod 6 and n = 5, 3, 1 for R, G, B, so no per-sector branching.
     
     Args:
         h: Hue values (0-360) as numpy array
-        s: Saturation (0-1) as scalar
-        v: Value/brightness (0-1) as scalar
+        s: Saturation (0-1) as scalar or per-pixel array matching h
+        v: Value/brightness (0-1) as scalar or per-pixel array matching h
+        out: Optional (len(h), 3) uint8 array to write into (e.g. a pattern's pixels)
         
     Returns:
-        RGB array of shape (len(h), 3) with values 0-255
+        RGB array of shape (len(h), 3) with values 0-255 (out if given)
     """
     if not isinstance(h, np.ndarray) or h.size == 0:
         return np.zeros((0, 3), dtype=np.uint8)
     
-    # Ensure valid ranges
-    s = np.clip(s, 0.0, 1.0)
-    v = np.clip(v, 0.0, 1.0)
+    count = h.shape[0]
+    if out is None:
+        out = np.empty((count, 3), dtype=np.uint8)
+    elif out.shape != (count, 3) or out.dtype != np.uint8:
+        raise ValueError(f"Output must be uint8 of shape ({count}, 3), got {out.dtype} {out.shape}")
     
-    # OpenCV uses H: 0-179, S: 0-255, V: 0-255
-    h_cv = ((h % 360) / 2).astype(np.uint8)  # Convert 0-360 to 0-179
-    s_cv = int(s * 255)
-    v_cv = int(v * 255)
+    # Ensure valid ranges, scaled once to 0-255 (+0.5 rounds on the uint8 cast)
+    value = np.clip(v, 0.0, 1.0) * 255.0
+    chroma = value * np.clip(s, 0.0, 1.0)
+    value = value + 0.5
     
-    # Create HSV array with shape (1, n_pixels, 3)
-    hsv = np.stack([h_cv, 
-                    np.full_like(h_cv, s_cv),
-                    np.full_like(h_cv, v_cv)], axis=-1)
-    hsv = hsv.reshape(1, -1, 3)
+    sector = np.mod(h, 360.0, dtype=np.float32)
+    sector /= 60.0
+    k = np.empty_like(sector)
+    weight = np.empty_like(sector)
     
-    # Convert to RGB using OpenCV
-    rgb = cv2.cvtColor(hsv, cv2.COLOR_HSV2RGB)
+    for channel, offset in enumerate((5.0, 3.0, 1.0)):
+        np.add(sector, offset, out=k)
+        np.mod(k, 6.0, out=k)
+        np.subtract(4.0, k, out=weight)
+        np.minimum(k, weight, out=weight)
+        np.clip(weight, 0.0, 1.0, out=weight)
+        weight *= chroma
+        np.subtract(value, weight, out=weight)
+        out[:, channel] = weight
     
-    # Reshape back to (n_pixels, 3)
-    return rgb.reshape(-1, 3)
\ No newline at end of file
+    return out
@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+"""
+Compositor - Several patterns per zone, blended into one frame
+Each layer renders into its own preallocated buffer and is blended into the
+zone view with 8-bit integer math in scratch arrays, so frames allocate nothing
+"""
+
+import math
+import numpy as np
+from typing import Any, Dict, List, Tuple
+from patterns.base import Pattern
+from patterns.registry import PatternRegistry
+
+BLEND_MODES = ('alpha', 'add', 'screen', 'multiply', 'max')
+
+# Modes where a black layer leaves the frame unchanged, so it can be skipped
+BLACK_IS_IDENTITY = ('add', 'screen', 'max')
+
+
+def _div255(values: np.ndarray, scratch: np.ndarray):
+    """values = round(values / 255) in place, exact for products of two 8-bit values"""
+    values += 128
+    np.right_shift(values, 8, out=scratch)
+    values += scratch
+    values >>= 8
+
+
+def blend(out: np.ndarray, layer: np.ndarray, mode: str, opacity: float,
+          wide: np.ndarray, carry: np.ndarray):
+    """
+    Blend layer into out in place at opacity (0-1)
+
+    Args:
+        out, layer: (led_count, 3) uint8 frames
+        wide, carry: (led_count, 3) uint16 scratch, contents discarded
+    """
+    weight = min(max(int(round(opacity * 256)), 0), 256)
+
+    if mode == 'alpha':
+        # out + (layer - out) * opacity, as (layer * w + out * (256 - w)) >> 8
+        np.multiply(layer, weight, out=wide, dtype=np.uint16)
+        np.multiply(out, 256 - weight, out=carry, dtype=np.uint16)
+        wide += carry
+        wide >>= 8
+        np.copyto(out, wide, casting='unsafe')
+        return
+
+    if mode == 'multiply':
+        # Fade the layer toward white (the identity) by opacity: 255 - (255 - layer) * w >> 8
+        np.subtract(255, layer, out=wide, dtype=np.uint16)
+        wide *= weight
+        wide >>= 8
+        np.subtract(255, wide, out=wide)
+        wide *= out
+        _div255(wide, carry)
+        np.copyto(out, wide, casting='unsafe')
+        return
+
+    # add, screen, max: fade the layer toward black by opacity
+    np.copyto(wide, layer)
+    if weight < 256:
+        wide *= weight
+        wide >>= 8
+
+    if mode == 'add':
+        wide += out
+        np.minimum(wide, 255, out=wide)
+    elif mode == 'screen':
+        # 255 - (255 - out)(255 - layer) / 255
+        np.subtract(255, wide, out=wide)
+        np.subtract(255, out, out=carry, dtype=np.uint16)
+        wide *= carry
+        _div255(wide, carry)
+        np.subtract(255, wide, out=wide)
+    else:
+        np.maximum(wide, out, out=wide)
+    np.copyto(out, wide, casting='unsafe')
+
+
+class Layer:
+    """One pattern in a LayerStack with its blend mode and opacity"""
+
+    def __init__(self, pattern: Pattern, blend: str = 'alpha', opacity: float = 1.0,
+                 audio: bool = False):
+        """
+        Args:
+            pattern: Pattern rendering this layer
+            blend: How the layer combines with the layers below (BLEND_MODES)
+            opacity: 0-1; zero-opacity layers are not rendered at all
+            audio: Scale opacity by the smoothed audio RMS each frame
+        """
+        if blend not in BLEND_MODES:
+            raise ValueError(f"Unknown blend mode '{blend}', expected one of {BLEND_MODES}")
+        if not 0.0 <= opacity <= 1.0:
+            raise ValueError(f"Layer opacity must be 0-1, got {opacity}")
+
+        self.pattern = pattern
+        self.blend = blend
+        self.opacity = opacity
+        self.audio = audio
+        self.buffer = np.zeros((pattern.led_count, 3), dtype=np.uint8)
+
+    def effective_opacity(self) -> float:
+        if self.audio:
+            if self.pattern.audio is None:
+                return 0.0
+            return self.opacity * self.pattern.audio.features.rms
+        return self.opacity
+
+
+class LayerStack(Pattern):
+    """
+    Pattern that composites its layers bottom to top over black
+
+    Cost scales with the layers that contribute: zero-opacity layers are
+    neither rendered nor blended, and all-black add/screen/max layers are
+    rendered (they may be animating) but not blended. The bottom layer
+    renders straight into the zone view when it is opaque. Below full
+    quality the topmost layers are shed first; the bottom layer always runs.
+    """
+
+    def __init__(self, led_count: int, layers: List[Layer], fps: float = 30.0):
+        if not layers:
+            raise ValueError("LayerStack needs at least one layer")
+        for layer in layers:
+            if layer.pattern.led_count != led_count:
+                raise ValueError(f"Layer pattern has {layer.pattern.led_count} LEDs but stack has {led_count}")
+        super().__init__(led_count, fps)
+
+        self.layers = layers
+        # Widened scratch for the blend arithmetic
+        self._wide = np.zeros((led_count, 3), dtype=np.uint16)
+        self._carry = np.zeros((led_count, 3), dtype=np.uint16)
+        self.layers_blended = 0
+
+    @classmethod
+    def from_config(cls, layers_config: List[Dict[str, Any]], led_count: int) -> 'LayerStack':
+        """
+        Build a stack from startup config entries, bottom layer first
+
+        Each entry: {pattern: name, blend: mode, opacity: 0-1, audio: bool,
+        params: {name: value}}; only pattern is required.
+        """
+        layers = []
+        for index, entry in enumerate(layers_config):
+            if 'pattern' not in entry:
+                raise ValueError(f"Layer {index} missing 'pattern'")
+            pattern = PatternRegistry.create_pattern(entry['pattern'], led_count)
+            if pattern is None:
+                raise ValueError(f"Layer {index}: unknown pattern '{entry['pattern']}'")
+            for name, value in (entry['params'] if 'params' in entry else {}).items():
+                pattern.set_param(name, value)
+            layers.append(Layer(pattern,
+                                entry['blend'] if 'blend' in entry else 'alpha',
+                                entry['opacity'] if 'opacity' in entry else 1.0,
+                                entry['audio'] if 'audio' in entry else False))
+        return cls(led_count, layers)
+
+    def get_default_params(self) -> Dict[str, Any]:
+        return {}
+
+    def bind_geometry(self, geometry):
+        super().bind_geometry(geometry)
+        for layer in self.layers:
+            layer.pattern.bind_geometry(geometry)
+
+    def bind_audio(self, analyzer):
+        super().bind_audio(analyzer)
+        for layer in self.layers:
+            layer.pattern.bind_audio(analyzer)
+
+    def prewarm(self):
+        for layer in self.layers:
+            layer.pattern.prewarm()
+
+    def reset(self):
+        super().reset()
+        for layer in self.layers:
+            layer.pattern.reset()
+
+    def close(self):
+        for layer in self.layers:
+            layer.pattern.close()
+
+    def set_quality(self, quality: float):
+        super().set_quality(quality)
+        for layer in self.layers:
+            layer.pattern.set_quality(quality)
+
+    def update(self, delta_time: float) -> np.ndarray:
+        out = self.pixels
+        empty = True
+        blended = 0
+        active = max(1, int(np.ceil(len(self.layers) * self.quality)))
+
+        for layer in self.layers[:active]:
+            opacity = layer.effective_opacity()
+            if opacity <= 0.0:
+                continue
+
+            if empty and opacity >= 1.0 and layer.blend != 'multiply':
+                # Anything but multiply over black is the layer itself
+                layer.pattern.render(out, self.now)
+                empty = False
+                blended += 1
+                continue
+
+            pixels = layer.pattern.render(layer.buffer, self.now)
+            if layer.blend in BLACK_IS_IDENTITY and not pixels.any():
+                continue
+            if empty:
+                out.fill(0)
+                empty = False
+            blend(out, pixels, layer.blend, opacity, self._wide, self._carry)
+            blended += 1
+
+        if empty:
+            out.fill(0)
+        self.layers_blended = blended
+        return out
+
+
+class Crossfade(Pattern):
+    """
+    Live transition from one pattern to another over duration seconds
+
+    Both patterns render every frame on the same clock - the outgoing one
+    straight into the zone view, the incoming one into a scratch buffer -
+    and are alpha-blended by elapsed time. Once finished it renders only
+    the incoming pattern until the controller retires it (advance_pattern).
+    """
+
+    def __init__(self, outgoing: Pattern, incoming: Pattern, duration: float, fps: float = 30.0):
+        if incoming.led_count != outgoing.led_count:
+            raise ValueError(f"Incoming pattern has {incoming.led_count} LEDs but outgoing has {outgoing.led_count}")
+        if not math.isfinite(duration) or duration <= 0:
+            raise ValueError(f"Crossfade duration must be positive and finite, got {duration}")
+        super().__init__(outgoing.led_count, fps)
+
+        self.outgoing = outgoing
+        self.incoming = incoming
+        self.duration = duration
+        self.geometry = outgoing.geometry
+        self.audio = outgoing.audio
+
+        self._buffer = np.zeros((self.led_count, 3), dtype=np.uint8)
+        self._wide = np.zeros((self.led_count, 3), dtype=np.uint16)
+        self._carry = np.zeros((self.led_count, 3), dtype=np.uint16)
+
+    def get_default_params(self) -> Dict[str, Any]:
+        return {}
+
+    def set_quality(self, quality: float):
+        super().set_quality(quality)
+        self.outgoing.set_quality(quality)
+        self.incoming.set_quality(quality)
+
+    @property
+    def progress(self) -> float:
+        """0 at the start of the fade, 1 once the incoming pattern is fully shown"""
+        return max(0.0, min(self.get_time() / self.duration, 1.0))
+
+    @property
+    def finished(self) -> bool:
+        return self.get_time() >= self.duration
+
+    def update(self, delta_time: float) -> np.ndarray:
+        if self.frame_number == 0:
+            # Frames are stamped with their clock tick, which can be just before
+            # the switch was made; the fade starts at the first one rendered
+            self.start_time = self.now
+        out = self.pixels
+        progress = self.progress
+        if progress >= 1.0:
+            self.incoming.render(out, self.now)
+            return out
+
+        self.outgoing.render(out, self.now)
+        incoming = self.incoming.render(self._buffer, self.now)
+        blend(out, incoming, 'alpha', progress, self._wide, self._carry)
+        return out
+
+
+def advance_pattern(current: Pattern, switch=None) -> Pattern:
+    """
+    Pattern the render loop should use next
+
+    Args:
+        current: Pattern rendered last frame
+        switch: Requested (incoming pattern, crossfade seconds) or None
+
+    Starts a crossfade (or cuts, for zero seconds) when a switch is requested,
+    and retires a finished Crossfade in favor of its incoming pattern.
+    """
+    if switch is not None:
+        incoming, duration = switch
+        if duration > 0:
+            return Crossfade(current, incoming, duration)
+        return incoming
+    if isinstance(current, Crossfade) and current.finished:
+        return current.incoming
+    return current
+
+
+def param_targets(pattern: Pattern, name: str) -> List[Tuple[Pattern, str]]:
+    """
+    (pattern, param) pairs a live update of name reaches
+
+    A Crossfade forwards to its incoming pattern. In a LayerStack, 'N.param'
+    addresses layer N and a plain name every layer that has it.
+    """
+    if isinstance(pattern, Crossfade):
+        return param_targets(pattern.incoming, name)
+    if isinstance(pattern, LayerStack):
+        index, _, param = name.partition('.')
+        if param and index.isdigit():
+            if int(index) >= len(pattern.layers):
+                return []
+            return param_targets(pattern.layers[int(index)].pattern, param)
+        return [target for layer in pattern.layers for target in param_targets(layer.pattern, name)]
+    return [(pattern, name)] if name in pattern.params else []
+
+
+def apply_params(pattern: Pattern, params: Dict[str, Any]) -> List[str]:
+    """
+    Set params between frames (see param_targets)
+
+    Returns:
+        Names no pattern had, which were skipped
+    """
+    unknown = []
+    for name, value in params.items():
+        targets = param_targets(pattern, name)
+        if not targets:
+            unknown.append(name)
+        for target, param in targets:
+            target.params[param] = value
+    return unknown
+
+
+def _compatible(current: Any, value: Any) -> bool:
+    """value can replace a param currently holding current"""
+    if current is None:
+        return True
+    if isinstance(current, bool) or isinstance(value, bool):
+        return isinstance(current, bool) and isinstance(value, bool)
+    if isinstance(current, (int, float)):
+        return isinstance(value, (int, float))
+    return isinstance(value, type(current))
+
+
+def check_params(pattern: Pattern, params: Dict[str, Any]):
+    """
+    Reject params that would break rendering, before they reach a live pattern
+
+    Every name must reach a pattern (see param_targets) with a value of the
+    param's current type. Each pattern reached is then rebuilt fresh with
+    its current params plus the new ones and renders one frame, so values
+    that only fail in the pattern's own math (a zero cycle time, an unknown
+    palette) are caught off the render threads.
+
+    Raises:
+        ValueError: Naming the first bad param and why
+    """
+    updates: Dict[int, Tuple[Pattern, Dict[str, Any]]] = {}
+    for name, value in params.items():
+        targets = param_targets(pattern, name)
+        if not targets:
+            raise ValueError(f"{pattern.__class__.__name__} has no param '{name}'")
+        for target, param in targets:
+            current = target.params[param]
+            if isinstance(value, float) and not math.isfinite(value):
+                raise ValueError(f"{target.__class__.__name__} param '{param}' must be finite, got {value}")
+            if not _compatible(current, value):
+                raise ValueError(f"{target.__class__.__name__} param '{param}' takes "
+                                 f"{type(current).__name__}, got {type(value).__name__}")
+            updates.setdefault(id(target), (target, {}))[1][param] = value
+
+    for target, changes in updates.values():
+        probe = type(target)(target.led_count, target.fps)
+        try:
+            probe.bind_geometry(target.geometry)
+            probe.params.update(target.params)
+            probe.params.update(changes)
+            probe.render()
+        except Exception as e:
+            raise ValueError(f"{target.__class__.__name__} cannot render with {changes}: {e}") from e
+        finally:
+            # Drop the probe's file mappings now rather than whenever it is collected
+            probe.close()
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Frame Files - Baked pattern output for playback without per-frame compute
+A header, the frames, then (delta encoding only) an offset index. Files are
+memory-mapped for reading, so raw frames are served straight from the page cache.
+"""
+
+import struct
+import numpy as np
+from pathlib import Path
+
+MAGIC = b'MSHF'
+VERSION = 1
+# magic, version, encoding, led_count, frame_count, fps, index offset; padded to 32 bytes
+HEADER = struct.Struct('<4sHBxIIfQ')
+HEADER_SIZE = 32
+
+# raw: every frame in full (led_count * 3 bytes)
+# delta: runs of LEDs that changed since the previous frame; frame 0 is stored in full
+ENCODINGS = {'raw': 0, 'delta': 1}
+
+
+class FrameFileWriter:
+    """Appends (led_count, 3) uint8 frames to a new frame file"""
+
+    def __init__(self, path: str, led_count: int, fps: float, encoding: str = 'delta'):
+        if encoding not in ENCODINGS:
+            raise ValueError(f"Unknown frame encoding '{encoding}', expected one of {list(ENCODINGS)}")
+        if led_count <= 0:
+            raise ValueError(f"LED count must be positive, got {led_count}")
+        if fps <= 0:
+            raise ValueError(f"FPS must be positive, got {fps}")
+
+        self.path = Path(path)
+        self.led_count = led_count
+        self.fps = fps
+        self.encoding = encoding
+        self.frame_count = 0
+
+        self._file = open(self.path, 'wb')
+        self._file.write(bytes(HEADER_SIZE))
+        self._offsets = []
+        self._previous = np.zeros((led_count, 3), dtype=np.uint8)
+
+    def add(self, frame: np.ndarray):
+        """Append one frame"""
+        if frame.shape != (self.led_count, 3) or frame.dtype != np.uint8:
+            raise ValueError(f"Frame must be ({self.led_count}, 3) uint8, got {frame.shape} {frame.dtype}")
+
+        if self.encoding == 'raw':
+            self._file.write(np.ascontiguousarray(frame).tobytes())
+        else:
+            self._offsets.append(self._file.tell())
+            if self.frame_count == 0:
+                starts = np.zeros(1, dtype='<u4')
+                lengths = np.full(1, self.led_count, dtype='<u4')
+            else:
+                changed = (frame != self._previous).any(axis=1).astype(np.int8)
+                edges = np.diff(np.concatenate(([0], changed, [0])))
+                starts = np.flatnonzero(edges == 1).astype('<u4')
+                lengths = (np.flatnonzero(edges == -1) - starts).astype('<u4')
+            self._file.write(struct.pack('<I', len(starts)))
+            self._file.write(starts.tobytes())
+            self._file.write(lengths.tobytes())
+            for start, length in zip(starts, lengths):
+                self._file.write(np.ascontiguousarray(frame[start:start + length]).tobytes())
+        np.copyto(self._previous, frame)
+        self.frame_count += 1
+
+    def close(self):
+        """Write the index and header"""
+        index_offset = 0
+        if self.encoding == 'delta':
+            index_offset = self._file.tell()
+            self._file.write(np.asarray(self._offsets, dtype='<u8').tobytes())
+        self._file.seek(0)
+        self._file.write(HEADER.pack(MAGIC, VERSION, ENCODINGS[self.encoding], self.led_count,
+                                     self.frame_count, self.fps, index_offset))
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class FrameFile:
+    """Memory-mapped frame file, read sequentially or by frame index"""
+
+    def __init__(self, path: str):
+        self.path = Path(path)
+        self._map = np.memmap(self.path, dtype=np.uint8, mode='r')
+        if self._map.size < HEADER_SIZE:
+            raise ValueError(f"{self.path} is not a frame file (too short)")
+
+        magic, version, encoding, led_count, frame_count, fps, index_offset = HEADER.unpack(
+            self._map[:HEADER.size].tobytes())
+        if magic != MAGIC:
+            raise ValueError(f"{self.path} is not a frame file")
+        if version != VERSION:
+            raise ValueError(f"{self.path} is frame file version {version}, expected {VERSION}")
+        if frame_count == 0:
+            raise ValueError(f"{self.path} has no frames")
+
+        self.led_count = led_count
+        self.frame_count = frame_count
+        self.fps = fps
+        self.encoding = {value: name for name, value in ENCODINGS.items()}[encoding]
+
+        if self.encoding == 'raw':
+            size = frame_count * led_count * 3
+            self._frames = self._map[HEADER_SIZE:HEADER_SIZE + size].reshape(frame_count, led_count, 3)
+        else:
+            self._index = np.frombuffer(self._map, dtype='<u8', count=frame_count, offset=index_offset)
+            self._current = np.zeros((led_count, 3), dtype=np.uint8)
+            self._position = -1
+
+    @property
+    def duration(self) -> float:
+        return self.frame_count / self.fps
+
+    def _apply(self, index: int):
+        """Apply delta frame index on top of _current"""
+        offset = int(self._index[index])
+        runs = int(np.frombuffer(self._map, dtype='<u4', count=1, offset=offset)[0])
+        starts = np.frombuffer(self._map, dtype='<u4', count=runs, offset=offset + 4)
+        lengths = np.frombuffer(self._map, dtype='<u4', count=runs, offset=offset + 4 + runs * 4)
+        data = offset + 4 + runs * 8
+        for start, length in zip(starts.tolist(), lengths.tolist()):
+            self._current[start:start + length] = np.frombuffer(
+                self._map, dtype=np.uint8, count=length * 3, offset=data).reshape(length, 3)
+            data += length * 3
+        self._position = index
+
+    def frame(self, index: int) -> np.ndarray:
+        """
+        (led_count, 3) frame index - a view owned by the file, do not modify
+
+        Raw files return a view into the mapping. Delta files decode forward
+        from the current position (restarting at frame 0 to go backwards),
+        so sequential and looping playback touch only the changed LEDs.
+        """
+        if not 0 <= index < self.frame_count:
+            raise IndexError(f"Frame {index} outside 0-{self.frame_count - 1}")
+        if self.encoding == 'raw':
+            return self._frames[index]
+
+        if index < self._position:
+            self._position = -1
+        for position in range(self._position + 1, index + 1):
+            self._apply(position)
+        return self._current
+
+    def close(self):
+        self._frames = None
+        self._map = None
+
+
+def bake_pattern(pattern, path: str, seconds: float, fps: float, encoding: str = 'delta') -> int:
+    """
+    Record seconds of pattern output to a frame file on a simulated clock
+
+    The pattern is reset, then frames are rendered as fast as it allows, each
+    at its exact timestamp (start + i / fps), so output matches live
+    rendering at fps.
+
+    Returns:
+        Frames written
+    """
+    frame = np.zeros((pattern.led_count, 3), dtype=np.uint8)
+    frames = max(1, int(round(seconds * fps)))
+    pattern.reset()
+    start = pattern.start_time
+    with FrameFileWriter(path, pattern.led_count, fps, encoding) as writer:
+        for index in range(frames):
+            pattern.render(frame, start + index / fps)
+            writer.add(frame)
+    return frames
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Geometry - Physical LED coordinates and derived per-LED arrays for patterns
+Built once per strip from its layout in led_config.yaml; patterns index the
+cached arrays instead of treating the strip as a 1D line
+"""
+
+import math
+import numpy as np
+from pathlib import Path
+from typing import Any, Dict, Optional
+
+# Nearest neighbors kept per LED for diffusion-style effects
+NEIGHBOR_COUNT = 6
+
+# Required parameters for each parametric layout
+LAYOUT_PARAMS = {
+    'line': ('length',),
+    'dome': ('radius', 'turns'),
+    'cylinder': ('radius', 'height', 'turns'),
+    'points': ('file',),
+}
+
+
+def _normalize(values: np.ndarray) -> np.ndarray:
+    """Scale to 0-1 over the array's own range (all zeros if it is constant)"""
+    span = float(values.max() - values.min())
+    if span <= 0:
+        return np.zeros(values.shape, dtype=np.float32)
+    return ((values - values.min()) / span).astype(np.float32)
+
+
+class Geometry:
+    """
+    Per-LED coordinates of one strip, in wire order
+
+    All arrays are float32 of length led_count unless noted:
+        xyz:      (led_count, 3) position in the mushroom's frame, z up
+        strip:    Index along the strip, i / led_count (the old 1D position)
+        angle:    Azimuth around the vertical axis in turns (0-1)
+        height:   z normalized over this strip (0 bottom, 1 top)
+        radius:   Distance from the vertical axis normalized over this strip
+        neighbors: (led_count, k) int32 nearest LEDs in space, built on first use
+    """
+
+    def __init__(self, xyz: np.ndarray):
+        xyz = np.array(xyz, dtype=np.float32)
+        if xyz.ndim != 2 or xyz.shape[1] != 3 or xyz.shape[0] == 0:
+            raise ValueError(f"LED coordinates must be (led_count, 3), got {xyz.shape}")
+
+        self.led_count = xyz.shape[0]
+        self.xyz = xyz
+        self.strip = np.arange(self.led_count, dtype=np.float32) / self.led_count
+        self.angle = (np.arctan2(xyz[:, 1], xyz[:, 0]) / (2 * math.pi) % 1.0).astype(np.float32)
+        self.height = _normalize(xyz[:, 2])
+        self.radius = _normalize(np.hypot(xyz[:, 0], xyz[:, 1]))
+        self._neighbors: Optional[np.ndarray] = None
+
+        for array in (self.xyz, self.strip, self.angle, self.height, self.radius):
+            array.flags.writeable = False
+
+    @classmethod
+    def line(cls, led_count: int, length: float = 1.0) -> 'Geometry':
+        """Straight strip along x - the layout patterns assumed before geometry existed"""
+        xyz = np.zeros((led_count, 3), dtype=np.float32)
+        xyz[:, 0] = np.arange(led_count) * (length / led_count)
+        return cls(xyz)
+
+    @classmethod
+    def dome(cls, led_count: int, radius: float, turns: float) -> 'Geometry':
+        """Spiral over a hemisphere from the apex (first LED) down to the rim"""
+        t = np.arange(led_count, dtype=np.float64) / max(led_count - 1, 1)
+        elevation = t * (math.pi / 2)
+        azimuth = t * turns * 2 * math.pi
+        xyz = np.stack([radius * np.sin(elevation) * np.cos(azimuth),
+                        radius * np.sin(elevation) * np.sin(azimuth),
+                        radius * np.cos(elevation)], axis=1)
+        return cls(xyz)
+
+    @classmethod
+    def cylinder(cls, led_count: int, radius: float, height: float, turns: float) -> 'Geometry':
+        """Helix around a cylinder from the bottom (first LED) to the top"""
+        t = np.arange(led_count, dtype=np.float64) / max(led_count - 1, 1)
+        azimuth = t * turns * 2 * math.pi
+        xyz = np.stack([radius * np.cos(azimuth),
+                        radius * np.sin(azimuth),
+                        t * height], axis=1)
+        return cls(xyz)
+
+    @classmethod
+    def points(cls, led_count: int, path: Path) -> 'Geometry':
+        """Measured coordinates, one x,y,z row per LED in wire order (.npy or .csv)"""
+        if path.suffix == '.npy':
+            xyz = np.load(path)
+        else:
+            xyz = np.loadtxt(path, delimiter=',', dtype=np.float32, ndmin=2)
+        if xyz.shape[0] != led_count:
+            raise ValueError(f"{path} has {xyz.shape[0]} coordinates for {led_count} LEDs")
+        return cls(xyz)
+
+    @classmethod
+    def from_config(cls, strip: Dict[str, Any], base_dir: Path) -> 'Geometry':
+        """
+        Build a strip's geometry from its optional layout block
+
+        Args:
+            strip: Entry from the strips list (id, led_count, layout)
+            base_dir: Directory relative points files are resolved against
+        """
+        led_count = strip['led_count']
+        if 'layout' not in strip:
+            return cls.line(led_count)
+
+        layout = strip['layout']
+        prefix = f"strips.{strip['id']}.layout"
+        if 'type' not in layout:
+            raise ValueError(f"Config missing '{prefix}.type'")
+        kind = layout['type']
+        if kind not in LAYOUT_PARAMS:
+            raise ValueError(f"{prefix}.type must be one of {list(LAYOUT_PARAMS)}, got '{kind}'")
+        for key in LAYOUT_PARAMS[kind]:
+            if key not in layout:
+                raise ValueError(f"Config missing '{prefix}.{key}'")
+
+        if kind == 'line':
+            geometry = cls.line(led_count, layout['length'])
+        elif kind == 'dome':
+            geometry = cls.dome(led_count, layout['radius'], layout['turns'])
+        elif kind == 'cylinder':
+            geometry = cls.cylinder(led_count, layout['radius'], layout['height'], layout['turns'])
+        else:
+            geometry = cls.points(led_count, base_dir / layout['file'])
+
+        # Place the strip in the shared frame, e.g. the cap above the stem
+        if 'offset' in layout:
+            geometry = cls(geometry.xyz + np.asarray(layout['offset'], dtype=np.float32))
+        return geometry
+
+    @property
+    def neighbors(self) -> np.ndarray:
+        """Indices of each LED's nearest LEDs (excluding itself), nearest first"""
+        if self._neighbors is None:
+            k = min(NEIGHBOR_COUNT, self.led_count - 1)
+            neighbors = np.zeros((self.led_count, k), dtype=np.int32)
+            # Row blocks keep the distance matrix small for thousands of LEDs
+            for start in range(0, self.led_count if k > 0 else 0, 256):
+                block = self.xyz[start:start + 256]
+                distances = ((block[:, None, :] - self.xyz[None, :, :]) ** 2).sum(axis=2)
+                distances[np.arange(len(block)), np.arange(start, start + len(block))] = np.inf
+                nearest = np.argpartition(distances, k - 1, axis=1)[:, :k]
+                order = np.argsort(np.take_along_axis(distances, nearest, axis=1), axis=1)
+                neighbors[start:start + len(block)] = np.take_along_axis(nearest, order, axis=1)
+            neighbors.flags.writeable = False
+            self._neighbors = neighbors
+        return self._neighbors
+
+    def distance_from(self, point, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """Distance of every LED from point (x, y, z), for radial effects"""
+        if out is None:
+            out = np.empty(self.led_count, dtype=np.float32)
+        np.sqrt(((self.xyz - np.asarray(point, dtype=np.float32)) ** 2).sum(axis=1), out=out)
+        return out
+
+    def diffuse(self, values: np.ndarray, amount: float, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        One diffusion step: blend each LED's value toward its neighbors' mean
+
+        Args:
+            values: (led_count,) or (led_count, channels) float array
+            amount: 0 keeps values, 1 replaces them with the neighbor mean
+        """
+        if out is None:
+            out = np.empty_like(values)
+        if self.led_count < 2:
+            np.copyto(out, values)
+            return out
+        mean = values[self.neighbors].mean(axis=1)
+        np.multiply(values, 1.0 - amount, out=out)
+        out += mean * amount
+        return out
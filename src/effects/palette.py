@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Palette Engine - Color palettes compiled once into RGB lookup tables
+Positions are 16-bit fixed-point phases, so mapping a frame is one integer
+add, a mask for wraparound and one gather from the LUT; a palette change
+crossfades the two LUTs, not every frame's pixels
+"""
+
+import numpy as np
+from typing import Dict, Optional, Sequence, Tuple
+from .colors import PALETTES, interpolate_stops
+from .compositor import blend
+
+# Fixed-point phase: 1.0 (one trip through the palette) is PHASE_ONE
+PHASE_BITS = 16
+PHASE_ONE = 1 << PHASE_BITS
+PHASE_MASK = PHASE_ONE - 1
+
+LUT_SIZES = (256, 1024)
+
+
+def to_phase(positions: np.ndarray, out: Optional[np.ndarray] = None) -> np.ndarray:
+    """Positions in palette trips (1.0 = once through) as uint32 fixed-point phases"""
+    if out is None:
+        out = np.empty(positions.shape, dtype=np.uint32)
+    # Through int64 so negative positions wrap instead of saturating
+    np.copyto(out, np.floor(positions * PHASE_ONE).astype(np.int64) & PHASE_MASK, casting='unsafe')
+    return out
+
+
+class Palette:
+    """
+    A palette's colors as a (size, 3) uint8 LUT
+
+    Build one per palette and map every frame through it. wrap palettes
+    are circular (the last color blends back into the first), for phases
+    that travel; plain ones are a gradient from the first to the last.
+    """
+
+    _compiled: Dict[Tuple[str, int], 'Palette'] = {}
+
+    def __init__(self, colors: Sequence[Tuple[int, int, int]], size: int = 256, wrap: bool = True):
+        if size not in LUT_SIZES:
+            raise ValueError(f"Palette size must be one of {LUT_SIZES}, got {size}")
+        self.size = size
+        self.wrap = wrap
+        self.lut = interpolate_stops(colors, size, wrap)
+        # Phase bits below the LUT index
+        self.shift = PHASE_BITS - (size.bit_length() - 1)
+
+    @classmethod
+    def named(cls, name: str, size: int = 256) -> 'Palette':
+        """Circular palette from PALETTES, compiled on first use and shared after"""
+        key = (name, size)
+        if key not in cls._compiled:
+            if name not in PALETTES:
+                raise ValueError(f"Unknown palette '{name}', expected one of {list(PALETTES)}")
+            cls._compiled[key] = cls(PALETTES[name], size)
+        return cls._compiled[key]
+
+    def copy(self) -> 'Palette':
+        palette = Palette.__new__(Palette)
+        palette.size = self.size
+        palette.wrap = self.wrap
+        palette.lut = self.lut.copy()
+        palette.shift = self.shift
+        return palette
+
+    def map(self, phases: np.ndarray, offset: int, out: np.ndarray, scratch: np.ndarray) -> np.ndarray:
+        """
+        out = colors at phases + offset, wrapping around the palette
+
+        Args:
+            phases: uint32 fixed-point per-LED phases (see to_phase)
+            offset: Fixed-point phase added to every LED (any int; wraps)
+            out: (len(phases), 3) uint8 array to write into (e.g. a zone view)
+            scratch: uint32 array like phases, contents discarded
+        """
+        np.add(phases, offset & PHASE_MASK, out=scratch)
+        scratch &= PHASE_MASK
+        scratch >>= self.shift
+        # clip never triggers after the mask; it lets take write into out unbuffered
+        np.take(self.lut, scratch, axis=0, out=out, mode='clip')
+        return out
+
+
+class PaletteFade:
+    """
+    A pattern's live palette, crossfading LUT to LUT on a change
+
+    output is the palette to map through this frame; advance() blends the
+    outgoing and incoming LUTs, size entries per frame however many LEDs
+    map through them.
+    """
+
+    def __init__(self, palette: Palette):
+        self.output = palette.copy()
+        self.source = palette
+        self.target = palette
+        self.duration = 0.0
+        self.elapsed = 0.0
+        self._wide = np.zeros((palette.size, 3), dtype=np.uint16)
+        self._carry = np.zeros((palette.size, 3), dtype=np.uint16)
+
+    @property
+    def fading(self) -> bool:
+        return self.source is not self.target
+
+    def fade_to(self, palette: Palette, duration: float):
+        """Start a crossfade from the current colors (mid-fade included) to palette"""
+        if palette.size != self.output.size:
+            raise ValueError(f"Cannot fade a {self.output.size}-entry palette to {palette.size} entries")
+        if palette is self.target:
+            return
+        self.source = self.output.copy() if self.fading else self.target
+        self.target = palette
+        self.duration = max(duration, 0.0)
+        self.elapsed = 0.0
+        self.output.wrap = palette.wrap
+
+    def advance(self, delta_time: float) -> Palette:
+        """Step the crossfade; returns the palette for this frame"""
+        if not self.fading:
+            return self.output
+        self.elapsed += delta_time
+        if self.elapsed >= self.duration:
+            np.copyto(self.output.lut, self.target.lut)
+            self.source = self.target
+        else:
+            np.copyto(self.output.lut, self.source.lut)
+            blend(self.output.lut, self.target.lut, 'alpha', self.elapsed / self.duration, self._wide, self._carry)
+        return self.output
+
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+Particle System - Structure-of-arrays particle pool for LED patterns
+Keeps every particle attribute in a parallel NumPy array so spawning,
+lifecycle envelopes and rendering are each one vectorized step
+"""
+
+import numpy as np
+from typing import Optional, Tuple
+from .colors import hsv_to_rgb
+
+Range = Tuple[float, float]
+
+
+class ParticleSystem:
+    """Fixed-capacity pool of fade-in / peak / fade-out particles on an LED strip"""
+
+    def __init__(self, capacity: int, led_count: int, exclusive: bool = True,
+                 rng: Optional[np.random.Generator] = None):
+        """
+        Args:
+            capacity: Maximum number of live particles
+            led_count: Number of LEDs particles can occupy
+            exclusive: At most one particle per LED (otherwise particles add up)
+            rng: Random generator (seed it for reproducible output)
+        """
+        if capacity <= 0:
+            raise ValueError(f"Particle capacity must be positive, got {capacity}")
+        if led_count <= 0:
+            raise ValueError(f"LED count must be positive, got {led_count}")
+
+        self.capacity = capacity
+        self.led_count = led_count
+        self.exclusive = exclusive
+        self.rng = rng if rng is not None else np.random.default_rng()
+
+        # Particle attributes, one slot per particle
+        self.active = np.zeros(capacity, dtype=bool)
+        self.position = np.zeros(capacity, dtype=np.intp)
+        self.birth = np.zeros(capacity, dtype=np.float64)
+        self.fade_in = np.ones(capacity, dtype=np.float32)
+        self.peak = np.zeros(capacity, dtype=np.float32)
+        self.fade_out = np.ones(capacity, dtype=np.float32)
+        self.brightness = np.zeros(capacity, dtype=np.float32)
+        self.hue = np.zeros(capacity, dtype=np.float32)
+        self.saturation = np.zeros(capacity, dtype=np.float32)
+
+        # Free-list stack of slot indices and LED occupancy bitmap
+        self._free = np.arange(capacity - 1, -1, -1, dtype=np.intp)
+        self._free_count = capacity
+        self.occupied = np.zeros(led_count, dtype=bool)
+
+        # Per-frame scratch
+        self._envelope = np.zeros(capacity, dtype=np.float32)
+        self._scratch = np.zeros(capacity, dtype=np.float32)
+        self._accum = np.zeros((led_count, 3), dtype=np.float64)
+
+    @property
+    def active_count(self) -> int:
+        return self.capacity - self._free_count
+
+    def spawn(self, count: int, now: float, fade_in: Range, peak: Range, fade_out: Range,
+              brightness: Range, hue: Range, saturation: Range) -> int:
+        """
+        Spawn up to count particles at random free positions
+
+        Each attribute is drawn uniformly from its (min, max) range.
+
+        Returns:
+            Number of particles actually spawned
+        """
+        count = min(count, self._free_count)
+        if count <= 0:
+            return 0
+
+        if self.exclusive:
+            free_leds = np.flatnonzero(~self.occupied)
+            count = min(count, free_leds.size)
+            if count == 0:
+                return 0
+            positions = self.rng.choice(free_leds, size=count, replace=False)
+            self.occupied[positions] = True
+        else:
+            positions = self.rng.integers(0, self.led_count, size=count)
+
+        slots = self._free[self._free_count - count:self._free_count]
+        self._free_count -= count
+
+        self.active[slots] = True
+        self.position[slots] = positions
+        self.birth[slots] = now
+        self.fade_in[slots] = self.rng.uniform(*fade_in, size=count)
+        self.peak[slots] = self.rng.uniform(*peak, size=count)
+        self.fade_out[slots] = self.rng.uniform(*fade_out, size=count)
+        self.brightness[slots] = self.rng.uniform(*brightness, size=count)
+        self.hue[slots] = self.rng.uniform(*hue, size=count)
+        self.saturation[slots] = self.rng.uniform(*saturation, size=count)
+        return count
+
+    def step(self, now: float) -> np.ndarray:
+        """
+        Compute each particle's envelope (0-1) and retire finished particles
+
+        The envelope is min(rising ramp, falling ramp) clamped to 0-1, which
+        gives the fade in, flat peak and fade out phases without branching.
+
+        Returns:
+            Envelope per slot (0 for inactive slots)
+        """
+        envelope = self._envelope
+        scratch = self._scratch
+
+        # Rising ramp: age / fade_in
+        np.subtract(now, self.birth, out=envelope, casting='same_kind')
+        np.subtract(envelope, self.fade_in + self.peak, out=scratch)
+        np.divide(envelope, self.fade_in, out=envelope)
+
+        # Falling ramp: 1 - (age - fade_in - peak) / fade_out
+        np.divide(scratch, self.fade_out, out=scratch)
+        np.subtract(1.0, scratch, out=scratch)
+
+        np.minimum(envelope, scratch, out=envelope)
+        np.clip(envelope, 0.0, 1.0, out=envelope)
+
+        # Falling ramp below zero means the lifecycle is complete
+        finished = self.active & (scratch <= 0.0)
+        if finished.any():
+            slots = np.flatnonzero(finished)
+            if self.exclusive:
+                self.occupied[self.position[slots]] = False
+            self.active[slots] = False
+            self._free[self._free_count:self._free_count + slots.size] = slots
+            self._free_count += slots.size
+
+        envelope[~self.active] = 0.0
+        return envelope
+
+    def render(self, pixels: np.ndarray, now: float, gain: float = 1.0,
+               min_value: float = 0.001) -> np.ndarray:
+        """
+        Step all particles and draw them into pixels (cleared first)
+
+        Args:
+            pixels: (led_count, 3) uint8 output, e.g. a pattern's zone view
+            now: Current time in seconds
+            gain: Multiplier applied to every particle's value
+            min_value: Particles dimmer than this are skipped
+        """
+        envelope = self.step(now)
+        np.multiply(envelope, self.brightness, out=envelope)
+        envelope *= gain
+
+        pixels.fill(0)
+        visible = np.flatnonzero(envelope > min_value)
+        if visible.size == 0:
+            return pixels
+
+        rgb = hsv_to_rgb(self.hue[visible], self.saturation[visible], envelope[visible])
+        positions = self.position[visible]
+
+        if self.exclusive:
+            pixels[positions] = rgb
+        else:
+            # Scatter-add overlapping particles, saturating at 255
+            for channel in range(3):
+                self._accum[:, channel] = np.bincount(positions, weights=rgb[:, channel],
+                                                      minlength=self.led_count)
+            np.minimum(self._accum, 255.0, out=self._accum)
+            pixels[:] = self._accum
+
+        return pixels
+
+    def clear(self):
+        """Retire every particle"""
+        self.active.fill(False)
+        self.occupied.fill(False)
+        self._free[:] = np.arange(self.capacity - 1, -1, -1, dtype=np.intp)
+        self._free_count = self.capacity
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Frame Buffer - Triple-buffered LED frame shared by all zones
+Patterns render straight into zone views of the back slot; the SPI thread
+encodes each zone's freshest slot in place, so frames are swapped, never copied
+"""
+
+import heapq
+import time
+import numpy as np
+from typing import List, Tuple
+
+
+class ZoneBuffer:
+    """
+    Latest-frame-wins triple buffer for one zone of the shared frame
+
+    One writer (pattern thread) owns the back slot, one reader (SPI thread)
+    owns the front slot, and the middle slot is exchanged atomically. The
+    middle value packs the slot index with a fresh flag: (slot << 1) | fresh.
+    """
+
+    def __init__(self, slots: List[np.ndarray], start: int):
+        if len(slots) != 3:
+            raise ValueError(f"Triple buffer needs 3 slots, got {len(slots)}")
+
+        self.start = start
+        self.count = slots[0].shape[0]
+        self._slots = slots
+        # Flat (count * 3,) channel views of the same slots, for byte-addressed writers
+        self._channels = [slot.reshape(-1) for slot in slots]
+
+        self._back = 0
+        self._front = 1
+        self._middle = [2 << 1]
+        self._published = 2
+
+        # time.time() each slot was last published, for handoff latency
+        self._published_at = [0.0] * 3
+
+        self.frames_published = 0
+        self.frames_dropped = 0
+        self.frames_repeated = 0
+
+    @staticmethod
+    def _exchange(cell: list, value: int) -> int:
+        """
+        Atomically swap value into a one-element list and return the old value
+        heapreplace on a single-item heap is one C call with no comparisons,
+        so it cannot be interrupted by another Python thread
+        """
+        return heapq.heapreplace(cell, value)
+
+    @property
+    def back(self) -> np.ndarray:
+        """Writable view for the frame currently being rendered"""
+        return self._slots[self._back]
+
+    @property
+    def back_channels(self) -> np.ndarray:
+        """back as a flat view of count * 3 channels"""
+        return self._channels[self._back]
+
+    @property
+    def published_channels(self) -> np.ndarray:
+        """
+        Channels of the frame the writer published last (read-only for the writer)
+
+        The writer cannot be handed this slot back before its next publish,
+        so it may read it to carry unchanged channels into the back slot.
+        """
+        return self._channels[self._published]
+
+    @property
+    def front_published_at(self) -> float:
+        """When the frame last returned by acquire() was published"""
+        return self._published_at[self._front]
+
+    def publish(self):
+        """Writer: make the back slot the latest frame and take a free slot"""
+        self._published_at[self._back] = time.time()
+        self._published = self._back
+        previous = self._exchange(self._middle, (self._back << 1) | 1)
+        self._back = previous >> 1
+        self.frames_published += 1
+        if previous & 1:
+            self.frames_dropped += 1
+
+    def acquire(self) -> Tuple[np.ndarray, bool]:
+        """
+        Reader: get the freshest complete frame without blocking
+
+        Returns:
+            Tuple of (pixels view, True if the frame is new since last acquire)
+        """
+        if self._middle[0] & 1:
+            previous = self._exchange(self._middle, self._front << 1)
+            self._front = previous >> 1
+            return self._slots[self._front], True
+
+        self.frames_repeated += 1
+        return self._slots[self._front], False
+
+
+class FrameBuffer:
+    """Contiguous (led_count, 3) frame in three slots, split into zone triple buffers"""
+
+    SLOTS = 3
+
+    def __init__(self, led_count: int):
+        if led_count <= 0:
+            raise ValueError(f"LED count must be positive, got {led_count}")
+
+        self.led_count = led_count
+        self.frames = np.zeros((self.SLOTS, led_count, 3), dtype=np.uint8)
+
+    def zone(self, start: int, count: int) -> ZoneBuffer:
+        """Create a triple buffer over [start:start+count] of every slot"""
+        if count <= 0 or start < 0 or start + count > self.led_count:
+            raise ValueError(f"Zone {start}-{start + count} exceeds frame of {self.led_count} LEDs")
+        return ZoneBuffer([self.frames[slot, start:start + count] for slot in range(self.SLOTS)], start)
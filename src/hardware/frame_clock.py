@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Frame Clock - Shared frame deadlines and render budgets for the pattern loops
+Every zone renders frame n at the same timestamp (epoch + n / max_fps), so
+zones animate in lockstep and motion does not inherit scheduling jitter
+"""
+
+import time
+from typing import Tuple
+from .realtime import LatencyTracker
+
+# Quality steps when a pattern's render time crosses its share of the budget
+QUALITY_MIN = 0.25
+QUALITY_DROP = 0.85     # Multiplier per over-budget frame
+QUALITY_RAISE = 0.02    # Added per comfortably-under-budget frame
+OVER_BUDGET = 0.8       # Smoothed render time above this fraction of the budget degrades
+UNDER_BUDGET = 0.5      # ...and below this fraction recovers
+LOAD_SMOOTHING = 0.2    # EWMA weight of the newest frame
+
+
+class FrameClock:
+    """
+    Monotonic frame schedule at max_fps shared by every pattern loop
+
+    Deadlines run on time.monotonic(), which is system-wide, so worker
+    processes forked with the clock follow the same schedule. Frame
+    timestamps are returned in time.time() seconds for patterns.
+    """
+
+    def __init__(self, max_fps: float, target_fps: float):
+        if max_fps <= 0:
+            raise ValueError(f"performance.max_fps must be positive, got {max_fps}")
+        if not 0 < target_fps <= max_fps:
+            raise ValueError(f"performance.target_fps must be between 0 and max_fps ({max_fps}), got {target_fps}")
+
+        self.max_fps = max_fps
+        self.target_fps = target_fps
+        self.interval = 1.0 / max_fps
+        # A pattern may use this long per frame before target_fps is at risk
+        self.budget = 1.0 / target_fps
+        self._epoch_monotonic = time.monotonic()
+        self._epoch_wall = time.time()
+
+    def timestamp(self, frame: int) -> float:
+        """time.time()-based timestamp of frame n, identical for every zone"""
+        return self._epoch_wall + frame * self.interval
+
+    def current_frame(self) -> int:
+        """Frame whose deadline most recently passed"""
+        return int((time.monotonic() - self._epoch_monotonic) / self.interval)
+
+    def wait_next(self, frame: int, latency: LatencyTracker) -> Tuple[int, int]:
+        """
+        Sleep until the frame after frame is due
+
+        Running behind skips ahead to the current frame rather than
+        bursting through the missed ones.
+
+        Returns:
+            Tuple of (frame to render, frames skipped)
+        """
+        next_frame = frame + 1
+        current = self.current_frame()
+        if current > next_frame:
+            return current, current - next_frame
+
+        deadline = self._epoch_monotonic + next_frame * self.interval
+        delay = deadline - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+            latency.record(time.monotonic() - deadline)
+        return next_frame, 0
+
+
+class RenderBudget:
+    """
+    Adaptive quality for one zone's pattern
+
+    Smooths render time against the frame budget (1 / target_fps) and
+    lowers quality geometrically while over budget, raising it slowly
+    once there is headroom again.
+    """
+
+    def __init__(self, budget: float):
+        self.budget = budget
+        self.load = 0.0
+        self.quality = 1.0
+        self.frames_missed = 0
+
+    def record(self, render_seconds: float, skipped: int = 0) -> float:
+        """Account one rendered frame (and any frames lost before it); returns the new quality"""
+        self.load += LOAD_SMOOTHING * (render_seconds / self.budget - self.load)
+        self.frames_missed += skipped
+        if self.load > OVER_BUDGET or skipped:
+            self.quality = max(QUALITY_MIN, self.quality * QUALITY_DROP)
+        elif self.load < UNDER_BUDGET and self.quality < 1.0:
+            self.quality = min(1.0, self.quality + QUALITY_RAISE)
+        return self.quality
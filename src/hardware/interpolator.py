@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Frame Interpolator - Output frames blended between a zone's last two rendered frames
+Lets a pattern render slower than the wire: every transmit shows the 8-bit
+fixed-point lerp of the previous and latest frames at the current time, so
+motion stays smooth at the transmit rate one render interval behind
+"""
+
+import numpy as np
+from typing import Tuple
+from effects.compositor import blend
+
+# Render intervals are smoothed over frames; longer gaps (a stalled or
+# switching pattern) are held rather than stretched across seconds
+INTERVAL_SMOOTHING = 0.2
+MAX_INTERVAL = 0.25
+
+
+class FrameInterpolator:
+    """
+    Per-zone output stage between the frame handoff and the encoder
+
+    push() takes each newly rendered frame with its publish time; sample()
+    returns the frame to transmit now. The blend weight crosses from the
+    previous to the latest frame over the smoothed render interval, reaching
+    the latest frame exactly as the next one is due. A sample with the same
+    weight and frames as the last is reported unchanged, so an idle zone is
+    still skipped by the chain, and samples closer together than
+    min_interval repeat the last one so small chains do not spin at
+    thousands of transmits per second.
+    """
+
+    def __init__(self, led_count: int, min_interval: float):
+        """
+        Args:
+            led_count: LEDs in the zone
+            min_interval: Shortest time between distinct output frames (1 / max_fps)
+        """
+        self.led_count = led_count
+        self.min_interval = min_interval
+        self._previous = np.zeros((led_count, 3), dtype=np.uint8)
+        self._latest = np.zeros((led_count, 3), dtype=np.uint8)
+        self._output = np.zeros((led_count, 3), dtype=np.uint8)
+        self._wide = np.zeros((led_count, 3), dtype=np.uint16)
+        self._carry = np.zeros((led_count, 3), dtype=np.uint16)
+
+        self._latest_at = 0.0
+        self._interval = 0.0
+        self._weight = -1
+        self._sampled_at = 0.0
+
+        # Rendered frames received and frames transmitted
+        self.frames_in = 0
+        self.frames_out = 0
+
+    @property
+    def output_ratio(self) -> float:
+        """Transmitted frames per rendered frame (1 = no interpolation happening)"""
+        return self.frames_out / self.frames_in if self.frames_in else 0.0
+
+    def push(self, pixels: np.ndarray, published_at: float):
+        """Take a newly rendered frame; pixels is copied, so the handoff slot may be reused"""
+        self._previous, self._latest = self._latest, self._previous
+        np.copyto(self._latest, pixels)
+        if self.frames_in:
+            observed = min(published_at - self._latest_at, MAX_INTERVAL)
+            if self._interval == 0.0:
+                self._interval = observed
+            else:
+                self._interval += INTERVAL_SMOOTHING * (observed - self._interval)
+        else:
+            # Nothing to blend from yet
+            np.copyto(self._previous, pixels)
+        self._latest_at = published_at
+        self.frames_in += 1
+        self._weight = -1
+
+    def sample(self, now: float) -> Tuple[np.ndarray, bool]:
+        """
+        Frame to transmit at now
+
+        Returns:
+            Tuple of (pixels, changed since the last sample)
+        """
+        if self._interval > 0.0:
+            weight = int(min(max((now - self._latest_at) / self._interval, 0.0), 1.0) * 256)
+        else:
+            weight = 256
+        if weight == self._weight or (self._weight >= 0 and now - self._sampled_at < self.min_interval):
+            return self._output, False
+
+        np.copyto(self._output, self._previous)
+        if weight:
+            blend(self._output, self._latest, 'alpha', weight / 256, self._wide, self._carry)
+        self._weight = weight
+        self._sampled_at = now
+        self.frames_out += 1
+        return self._output, True
@@ -1,25 +1,45 @@
 #!/usr/bin/env python3
 """
-LED Controller - Single SPI with parallel pattern generation
-Uses 2 pattern threads but single SPI transmission on 700 LEDs
+LED Controller - Parallel pattern generation over one or more SPI chains
+Renders any number of zones on a shared pool of pattern threads (or one worker
+process per zone) and runs one transmit thread per SPI bus
 """
 
 import yaml
 import logging
+import math
+import os
 import time
 import threading
 import numpy as np
-from typing import Optional, Dict, Any
-from pi5neo import Pi5Neo
+from pathlib import Path
+from typing import Dict, Any
+from .frame_buffer import FrameBuffer
+from effects.compositor import apply_params, param_targets
+from effects.frame_file import FrameFile, FrameFileWriter
+from .output_chain import OutputChain
+from .output_lut import OutputLUT
+from .pixel_ingest import PixelIngest
+from .power import PowerLimiter
+from .frame_clock import FrameClock
+from .interpolator import FrameInterpolator
+from .realtime import load_thread_profiles, lock_memory
+from .render_pool import RenderPool
+from .zone import Zone, zones_from_config
+from .zone_process import ZoneWorker
+from monitoring import MetricsRegistry
 
 logger = logging.getLogger(__name__)
 
+# A chain that has not completed a frame cycle (sent or unchanged) for this long is stalled
+STALL_SECONDS = 2.0
+
 
 class LEDController:
-    """Manages LED strips with parallel pattern generation on single SPI"""
+    """Manages LED strips with parallel pattern generation on one or more SPI buses"""
     
     def __init__(self, config_path: str = "config/led_config.yaml"):
-        """Initialize LED controller with single SPI channel"""
+        """Initialize LED controller and open every configured SPI chain"""
         # Load configuration
         try:
             with open(config_path, 'r') as f:
@@ -39,11 +59,25 @@ class LEDController:
             raise ValueError("Config missing 'hardware.spi_speed_khz'")
         if 'brightness' not in hardware_config:
             raise ValueError("Config missing 'hardware.brightness'")
+        if 'color_order' not in hardware_config:
+            raise ValueError("Config missing 'hardware.color_order'")
+        if 'spi_streaming' not in hardware_config:
+            raise ValueError("Config missing 'hardware.spi_streaming'")
+        if 'spi_backend' not in hardware_config:
+            raise ValueError("Config missing 'hardware.spi_backend'")
+        for key in ('gamma', 'white_balance', 'dithering'):
+            if key not in hardware_config:
+                raise ValueError(f"Config missing 'hardware.{key}'")
             
         self.spi_device = hardware_config['spi_device']
         self.spi_speed = hardware_config['spi_speed_khz']
+        self.color_order = hardware_config['color_order']
+        self.spi_streaming = hardware_config['spi_streaming']
+        self.spi_backend = hardware_config['spi_backend']
         self.brightness = hardware_config['brightness']
-        self._brightness_factor = self.brightness / 255.0
+        self.gamma = hardware_config['gamma']
+        self.white_balance = hardware_config['white_balance']
+        self.dithering = hardware_config['dithering']
         
         # Get timing config - critical for performance
         if 'timing' not in self.config:
@@ -52,94 +86,347 @@ class LEDController:
         
         if 'ws2811_latch_delay_ms' not in timing_config:
             raise ValueError("Config missing 'timing.ws2811_latch_delay_ms'")
+        if 'keepalive_interval_s' not in timing_config:
+            raise ValueError("Config missing 'timing.keepalive_interval_s'")
+        if 'metrics_window_seconds' not in timing_config:
+            raise ValueError("Config missing 'timing.metrics_window_seconds'")
+        if 'max_consecutive_errors' not in timing_config:
+            raise ValueError("Config missing 'timing.max_consecutive_errors'")
         
         self.latch_delay = timing_config['ws2811_latch_delay_ms'] / 1000.0
         logger.info(f"Loaded latch_delay: {self.latch_delay}s ({timing_config['ws2811_latch_delay_ms']}ms)")
         
-        # Get LED counts from config
+        # Unchanged frames are not resent except as a periodic refresh
+        self.keepalive_interval = timing_config['keepalive_interval_s']
+        if self.keepalive_interval <= 0:
+            raise ValueError(f"timing.keepalive_interval_s must be positive, got {self.keepalive_interval}")
+        
+        # Stage latency histograms over a rolling window
+        self.metrics = MetricsRegistry(timing_config['metrics_window_seconds'])
+        self.max_consecutive_errors = timing_config['max_consecutive_errors']
+        
+        # Pattern threads render ahead of the SPI thread on a shared frame clock
+        # capped at max_fps; patterns degrade when they threaten target_fps
+        if 'performance' not in self.config:
+            raise ValueError(f"Config missing 'performance' section in {config_path}")
+        for key in ('max_fps', 'target_fps'):
+            if key not in self.config['performance']:
+                raise ValueError(f"Config missing 'performance.{key}'")
+        self.max_fps = self.config['performance']['max_fps']
+        self.target_fps = self.config['performance']['target_fps']
+        self.frame_clock = FrameClock(self.max_fps, self.target_fps)
+        self.render_interval = self.frame_clock.interval
+        
+        # threads: render_threads pattern threads share this interpreter;
+        # processes: one worker process per zone
+        if 'execution' not in self.config['performance']:
+            raise ValueError("Config missing 'performance.execution'")
+        self.execution = self.config['performance']['execution']
+        if self.execution not in ('threads', 'processes'):
+            raise ValueError(f"performance.execution must be 'threads' or 'processes', got '{self.execution}'")
+        if 'render_threads' not in self.config['performance']:
+            raise ValueError("Config missing 'performance.render_threads'")
+        self.render_threads = self.config['performance']['render_threads']
+        if not isinstance(self.render_threads, int) or self.render_threads <= 0:
+            raise ValueError(f"performance.render_threads must be a positive integer, got {self.render_threads}")
+        # Zones with TILEABLE patterns split into tiles of at least this many LEDs (0 = never)
+        if 'tile_leds' not in self.config['performance']:
+            raise ValueError("Config missing 'performance.tile_leds'")
+        self.tile_leds = self.config['performance']['tile_leds']
+        if not isinstance(self.tile_leds, int) or self.tile_leds < 0:
+            raise ValueError(f"performance.tile_leds must be a non-negative integer, got {self.tile_leds}")
+        
+        # CPU pinning and scheduling, applied by each thread to itself
+        self.thread_profiles = load_thread_profiles(self.config['performance'])
+        if 'lock_memory' not in self.config['performance']['threads']:
+            raise ValueError("Config missing 'performance.threads.lock_memory'")
+        if self.config['performance']['threads']['lock_memory']:
+            lock_memory()
+        
+        # Network pixel ingest replaces the patterns when enabled
+        if 'ingest' not in self.config:
+            raise ValueError(f"Config missing 'ingest' section in {config_path}")
+        if 'enabled' not in self.config['ingest']:
+            raise ValueError("Config missing 'ingest.enabled'")
+        self.ingest_enabled = self.config['ingest']['enabled']
+        if self.ingest_enabled and self.execution != 'threads':
+            raise ValueError("ingest.enabled needs performance.execution: threads (packets land in the shared frame)")
+        
+        # Zones come from the strips list, in wire order
         if 'strips' not in self.config:
             raise ValueError(f"Config missing 'strips' section in {config_path}")
-            
-        cap_config = None
-        stem_config = None
-        for strip in self.config['strips']:
-            if strip['id'] == 'cap_exterior':
-                cap_config = strip
-            elif strip['id'] == 'stem_interior':
-                stem_config = strip
-        
-        if not cap_config or not stem_config:
-            raise ValueError("Config must define 'cap_exterior' and 'stem_interior' strips")
-        
-        self.cap_led_count = cap_config['led_count']
-        self.stem_led_count = stem_config['led_count']
-        self.total_leds = self.cap_led_count + self.stem_led_count
-        
-        # Create single SPI instance for all LEDs
-        logger.info(f"Initializing single SPI for {self.total_leds} LEDs on {self.spi_device}")
-        self.spi = Pi5Neo(
-            spi_device=self.spi_device,
-            num_leds=self.total_leds,
-            spi_speed_khz=self.spi_speed
-        )
-        
-        # Patterns
-        self.cap_pattern = None
-        self.stem_pattern = None
-        
-        # Buffers for pattern outputs
-        self.cap_buffer = np.zeros((self.cap_led_count, 3), dtype=np.uint8)
-        self.stem_buffer = np.zeros((self.stem_led_count, 3), dtype=np.uint8)
-        self.cap_buffer_lock = threading.Lock()
-        self.stem_buffer_lock = threading.Lock()
+        zones = zones_from_config(self.config['strips'], self.spi_device, Path(config_path).parent,
+                                  self.frame_clock.budget)
+        self.zones: Dict[str, Zone] = {zone.name: zone for zone in zones}
+        self.total_leds = sum(zone.led_count for zone in zones)
+        
+        if self.execution == 'processes':
+            # Each zone's worker renders into its own shared-memory segment
+            self.frame_buffer = None
+            for zone in zones:
+                zone.buffer = ZoneWorker(zone.name, zone.led_count, self.frame_clock,
+                                         self.thread_profiles['pattern'], zone.worker_report)
+        else:
+            # Shared frame: each zone renders into its slice, in strips list order
+            self.frame_buffer = FrameBuffer(self.total_leds)
+            start = 0
+            for zone in zones:
+                zone.buffer = self.frame_buffer.zone(start, zone.led_count)
+                start += zone.led_count
+        
+        # Gamma/brightness correction per zone, applied in the encoder's lookup
+        for zone in zones:
+            zone.output = OutputLUT(zone.led_count, self.gamma, self.white_balance,
+                                    self.brightness, self.dithering)
+            # Optional blending between rendered frames at the transmit rate
+            if zone.interpolate:
+                zone.interpolator = FrameInterpolator(zone.led_count, self.render_interval)
+        
+        # Estimated current per supply rail, held under budget by scaling brightness
+        if 'power' not in self.config or 'enabled' not in self.config['power']:
+            raise ValueError(f"Config missing 'power.enabled' in {config_path}")
+        self.power = None
+        if self.config['power']['enabled']:
+            self.power = PowerLimiter(self.config['power'])
+            for zone in zones:
+                zone.power = self.power.add_zone(zone.name, zone.led_count, zone.power_rail)
+        
+        # Group zones into chains by SPI device, in strips list (wire) order
+        # Strips without their own spi_device share hardware.spi_device
+        self.chains = []
+        chains_by_device = {}
+        for zone in zones:
+            if zone.device not in chains_by_device:
+                # Same clock as Pi5Neo: 8 SPI bits per WS2811 bit
+                chain = OutputChain(zone.device, self.spi_speed * 1024 * 8, self.color_order,
+                                    self.spi_streaming, self.latch_delay, self.keepalive_interval,
+                                    self.spi_backend, self.metrics, self.thread_profiles['spi'])
+                chains_by_device[zone.device] = chain
+                self.chains.append(chain)
+            chains_by_device[zone.device].add_zone(zone.name, zone.buffer, zone.output, zone.chain_offset,
+                                                   zone.interpolator, zone.power)
+        # Chain index of each zone, for its per-chain FPS and SPI health
+        self.zone_chains = {zone.name: self.chains.index(chains_by_device[zone.device]) for zone in zones}
+        
+        for chain in self.chains:
+            chain.open()
+        
+        # All chains start each frame together so buses latch the same frame
+        self.frame_barrier = threading.Barrier(len(self.chains))
+        
+        # Threads execution: one pool of pattern threads shared by every zone,
+        # or the ingest thread writing received pixels in their place
+        self.render_pool = None
+        self.ingest = None
+        if self.ingest_enabled:
+            self.ingest = PixelIngest(zones, self.config['ingest'], self.thread_profiles['pattern'])
+            self.ingest.open()
+        elif self.execution == 'threads':
+            self.render_pool = RenderPool(zones, self.render_threads, self.frame_clock,
+                                          self.thread_profiles['pattern'], self.tile_leds)
         
         # Thread control
         self.running = False
-        self.cap_thread = None
-        self.stem_thread = None
-        self.spi_thread = None
-        
-        # Frame synchronization
-        self.cap_ready = threading.Event()
-        self.stem_ready = threading.Event()
-        self.cap_consumed = threading.Event()
-        self.stem_consumed = threading.Event()
-        self.cap_consumed.set()
-        self.stem_consumed.set()
-        
-        # Performance tracking
-        self.frames_sent = 0
-        self.last_fps_time = time.time()
-        self.current_fps = 0
-        
-        # Timing metrics (last frame only)
-        self.last_pattern_wait_ms = 0
-        self.last_buffer_prep_ms = 0
-        self.last_spi_transmit_ms = 0
-        self.last_cap_generation_ms = 0
-        self.last_stem_generation_ms = 0
-        
-        logger.info(f"LED Controller initialized: {self.cap_led_count} cap + {self.stem_led_count} stem = {self.total_leds} total")
+        self.spi_threads = []
+        
+        # Performance tracking, per chain: a stalled bus must show even when another keeps sending.
+        # fps counts every cycle that left the LEDs current, including unchanged
+        # frames not retransmitted; transmit fps and frames_sent only those sent
+        self.chain_frames_sent = [0] * len(self.chains)
+        self.chain_fps = [0.0] * len(self.chains)
+        self.chain_transmit_fps = [0.0] * len(self.chains)
+        self._fps_frames = [0] * len(self.chains)
+        self._fps_sent = [0] * len(self.chains)
+        self._fps_since = [time.time()] * len(self.chains)
+        self._last_cycle_at = [time.time()] * len(self.chains)
+        # time.monotonic() the first frame after start() was transmitted on any chain
+        self.first_frame_at = None
+        
+        # Per-thread SPI counters; consecutive errors reset on each success
+        self.spi_errors = [0] * len(self.chains)
+        self.spi_consecutive_errors = [0] * len(self.chains)
+        
+        self.barrier_histograms = [
+            self.metrics.histogram('barrier_wait_ms', "SPI thread wait for the other chains", chain=chain.device_path)
+            for chain in self.chains
+        ]
+        self.metrics.gauge('fps', "Frames per second on the slowest chain", lambda: self.current_fps)
+        for index, chain in enumerate(self.chains):
+            self.metrics.gauge('chain_fps', "Frames per second, unchanged ones included",
+                               lambda index=index: self.fps_of(index), chain=chain.device_path)
+            self.metrics.gauge('chain_transmit_fps', "Frames transmitted per second",
+                               lambda index=index: self.transmit_fps_of(index), chain=chain.device_path)
+        self.metrics.gauge('frames_skipped', "Unchanged frames not retransmitted",
+                           lambda: sum(chain.frames_skipped for chain in self.chains))
+        if self.render_pool:
+            self.metrics.gauge('tiles_rendered', "Zone pixel tiles rendered by the render pool",
+                               lambda: self.render_pool.tiles_rendered)
+        if self.power:
+            for rail in self.power.rails.values():
+                self.metrics.gauge('power_amps', "Estimated current drawn after limiting",
+                                   lambda rail=rail: rail.amps, rail=rail.name)
+                self.metrics.gauge('power_demand_amps', "Estimated current the frames ask for before limiting",
+                                   lambda rail=rail: rail.demand_amps, rail=rail.name)
+                self.metrics.gauge('power_scale', "Brightness scale applied to stay in budget (1 = none)",
+                                   lambda rail=rail: rail.scale, rail=rail.name)
+        if self.ingest:
+            self.metrics.gauge('ingest_packets', "Pixel packets received",
+                               lambda: self.ingest.packets_received)
+            self.metrics.gauge('ingest_frames', "Network frames completed and published",
+                               lambda: self.ingest.frames_completed)
+            self.metrics.gauge('ingest_dropped', "Pixel packets discarded as out of sequence",
+                               lambda: self.ingest.packets_dropped)
+        for zone in zones:
+            zone.histogram = self.metrics.histogram('pattern_ms', "Pattern render time per frame", zone=zone.name)
+            self.metrics.gauge('render_quality', "Adaptive pattern quality (1 = full)",
+                               lambda zone=zone: zone.budget.quality, zone=zone.name)
+            self.metrics.gauge('frames_dropped', "Frames overwritten before transmission",
+                               lambda zone=zone: zone.buffer.frames_dropped, zone=zone.name)
+            self.metrics.gauge('frames_repeated', "Transmits with no new frame",
+                               lambda zone=zone: zone.buffer.frames_repeated, zone=zone.name)
+            if zone.interpolator:
+                self.metrics.gauge('output_ratio', "Interpolated frames transmitted per rendered frame",
+                                   lambda zone=zone: zone.interpolator.output_ratio, zone=zone.name)
+        
+        layout = ' + '.join(f"{zone.led_count} {zone.name}" for zone in zones)
+        source = f"{self.ingest.protocol} ingest" if self.ingest else f"patterns in {self.execution}"
+        logger.info(f"LED Controller initialized: {layout} = {self.total_leds} total on {len(self.chains)} SPI chain(s), {source}")
+    
+    def zone(self, name: str) -> Zone:
+        """Zone by name (strips[].name, or its id when unnamed)"""
+        if name not in self.zones:
+            raise ValueError(f"Unknown zone '{name}', expected one of {list(self.zones)}")
+        return self.zones[name]
+    
+    @property
+    def last_buffer_prep_ms(self) -> float:
+        """Slowest chain encode time (last frame)"""
+        return max(chain.last_encode_ms for chain in self.chains)
+    
+    @property
+    def last_spi_transmit_ms(self) -> float:
+        """Slowest chain transmit time (last frame) - the frame's critical path"""
+        return max(chain.last_transmit_ms for chain in self.chains)
     
-    def _set_pattern(self, pattern, expected_count: int, zone_name: str):
-        """Helper to set a pattern with validation"""
+    def set_pattern(self, name: str, pattern):
+        """Set the pattern for a zone (before starting)"""
+        zone = self.zone(name)
         if self.running:
-            raise RuntimeError("Cannot change patterns while running")
+            raise RuntimeError("Cannot set patterns while running - use switch_pattern")
         
-        if pattern.led_count != expected_count:
+        if pattern.led_count != zone.led_count:
             # Non-fatal: patterns auto-created with correct count, this catches manual mismatches
-            logger.warning(f"{zone_name} pattern expects {pattern.led_count} LEDs but {zone_name.lower()} has {expected_count}")
+            logger.warning(f"{name} pattern expects {pattern.led_count} LEDs but {name} has {zone.led_count}")
         
-        pattern.set_brightness(self._brightness_factor)
-        return pattern
+        zone.pattern = pattern
     
-    def set_cap_pattern(self, pattern):
-        """Set pattern for cap LEDs"""
-        self.cap_pattern = self._set_pattern(pattern, self.cap_led_count, "Cap")
+    def switch_pattern(self, name: str, pattern, crossfade: float):
+        """
+        Crossfade a zone to pattern over crossfade seconds (0 cuts) without stopping
+        
+        Create, bind and prewarm the pattern before calling, so the render
+        pool (or worker process) only starts rendering it on its next frame.
+        The outgoing pattern is retired when the crossfade ends.
+        """
+        zone = self.zone(name)
+        if not self.running:
+            self.set_pattern(name, pattern)
+            return
+        
+        if pattern.led_count != zone.led_count:
+            raise ValueError(f"{name} pattern expects {pattern.led_count} LEDs but {name} has {zone.led_count}")
+        if not math.isfinite(crossfade) or crossfade < 0:
+            # NaN or inf would start a fade that never finishes
+            raise ValueError(f"Crossfade must be finite and non-negative, got {crossfade}")
+        if self.execution == 'processes':
+            zone.buffer.switch(pattern, crossfade)
+            zone.pattern = pattern
+        else:
+            zone.switches.put((pattern, crossfade))
+        logger.info(f"{name} switching to {pattern.__class__.__name__} over {crossfade}s")
     
-    def set_stem_pattern(self, pattern):
-        """Set pattern for stem LEDs"""
-        self.stem_pattern = self._set_pattern(pattern, self.stem_led_count, "Stem")
+    def set_params(self, name: str, params: Dict[str, Any]):
+        """
+        Update a zone's pattern params, applied together between two frames
+        
+        Safe from any thread: the update is queued and the render pool (or
+        worker process) applies it before rendering the zone's next frame.
+        A crossfading zone updates its incoming pattern; layer stacks take
+        'N.param' for layer N, or a plain name for every layer that has it.
+        """
+        zone = self.zone(name)
+        if not zone.pattern:
+            raise ValueError(f"{name} has no pattern")
+        unknown = [param for param in params if not param_targets(zone.pattern, param)]
+        if unknown:
+            raise ValueError(f"{name} pattern {zone.pattern.__class__.__name__} has no params {unknown}")
+        
+        if not self.running:
+            apply_params(zone.pattern, params)
+        elif self.execution == 'processes':
+            zone.buffer.set_params(params)
+            # Keep the controller's copy in step for later validation
+            apply_params(zone.pattern, params)
+        else:
+            zone.param_updates.put(dict(params))
+    
+    def show_boot_frame(self, path: str) -> bool:
+        """
+        Transmit frame 0 of a frame file on every chain once, before start()
+        
+        Lights the LEDs while patterns are still being imported and built;
+        the strips hold the frame until the first pattern frame replaces it.
+        Needs threads execution (the shared frame) and a file covering
+        every LED in strips list order, as written by save_boot_frame().
+        
+        Returns:
+            True if the frame was sent
+        """
+        if self.running:
+            raise RuntimeError("Boot frame must be shown before starting")
+        if self.frame_buffer is None:
+            logger.info("Boot frame skipped: needs performance.execution: threads")
+            return False
+        if not Path(path).exists():
+            logger.info(f"No boot frame at {path}")
+            return False
+        
+        frames = FrameFile(path)
+        if frames.led_count != self.total_leds:
+            logger.warning(f"Boot frame {path} has {frames.led_count} LEDs, expected {self.total_leds} - skipped")
+            frames.close()
+            return False
+        frame = frames.frame(0)
+        for zone in self.zones.values():
+            zone.buffer.back[:] = frame[zone.buffer.start:zone.buffer.start + zone.led_count]
+            zone.buffer.publish()
+        frames.close()
+        for chain in self.chains:
+            chain.send_frame()
+        return True
+    
+    def save_boot_frame(self, path: str):
+        """
+        Write the zones' latest frames as the next boot frame (threads execution)
+        
+        Reads each zone's last published slot, which the render pool leaves
+        alone until it publishes twice more; written to a temporary file and
+        renamed so a power cut never leaves a torn boot frame.
+        """
+        if self.frame_buffer is None:
+            raise RuntimeError("Boot frames need performance.execution: threads")
+        frame = np.zeros((self.total_leds, 3), dtype=np.uint8)
+        for zone in self.zones.values():
+            published = zone.buffer.published_channels.reshape(zone.led_count, 3)
+            frame[zone.buffer.start:zone.buffer.start + zone.led_count] = published
+        
+        temporary = f"{path}.tmp"
+        with FrameFileWriter(temporary, self.total_leds, self.max_fps, encoding='raw') as writer:
+            writer.add(frame)
+        with open(temporary, 'rb') as f:
+            os.fsync(f.fileno())
+        os.replace(temporary, path)
+        logger.info(f"Saved boot frame to {path}")
     
     def start(self):
         """Start pattern generation and SPI transmission threads"""
@@ -147,22 +434,36 @@ class LEDController:
             logger.warning("Controller already running")
             return
         
-        if not self.cap_pattern or not self.stem_pattern:
-            raise RuntimeError("Both patterns must be set before starting")
+        missing = [zone.name for zone in self.zones.values() if not zone.pattern]
+        if missing and not self.ingest:
+            raise RuntimeError(f"Every zone needs a pattern before starting, missing: {', '.join(missing)}")
         
         logger.info("Starting LED controller")
         self.running = True
         
-        # Start pattern generation threads
-        self.cap_thread = threading.Thread(target=self._cap_pattern_thread, daemon=True)
-        self.stem_thread = threading.Thread(target=self._stem_pattern_thread, daemon=True)
-        self.spi_thread = threading.Thread(target=self._spi_thread, daemon=True)
-        
-        self.cap_thread.start()
-        self.stem_thread.start()
-        self.spi_thread.start()
-        
-        logger.info("LED controller started with 3 threads")
+        # Start the render pool, or fork the workers before any of our threads exist
+        self.frame_barrier.reset()
+        if self.ingest:
+            self.ingest.start()
+            pattern_workers = f"{self.ingest.protocol} ingest for {len(self.zones)} zones"
+        elif self.execution == 'processes':
+            for zone in self.zones.values():
+                zone.buffer.start_worker(zone.pattern)
+            pattern_workers = f"{len(self.zones)} pattern processes"
+        else:
+            self.render_pool.start()
+            pattern_workers = f"{self.render_pool.thread_count} pattern threads for {len(self.zones)} zones"
+        
+        self._fps_since = [time.time()] * len(self.chains)
+        self._last_cycle_at = [time.time()] * len(self.chains)
+        self.spi_threads = [
+            threading.Thread(target=self._spi_thread, args=(index, chain), daemon=True)
+            for index, chain in enumerate(self.chains)
+        ]
+        for thread in self.spi_threads:
+            thread.start()
+        
+        logger.info(f"LED controller started with {pattern_workers} and {len(self.spi_threads)} SPI threads")
     
     def stop(self):
         """Stop all threads and clear LEDs"""
@@ -171,84 +472,173 @@ class LEDController:
         
         logger.info("Stopping LED controller")
         self.running = False
-        
-        # Signal threads to wake up
-        self.cap_consumed.set()
-        self.stem_consumed.set()
+        self.frame_barrier.abort()
         
         # Wait for threads to finish
-        if self.cap_thread and self.cap_thread.is_alive():
-            self.cap_thread.join(timeout=1.0)
-        if self.stem_thread and self.stem_thread.is_alive():
-            self.stem_thread.join(timeout=1.0)
-        if self.spi_thread and self.spi_thread.is_alive():
-            self.spi_thread.join(timeout=1.0)
+        if self.render_pool:
+            self.render_pool.stop()
+        if self.ingest:
+            self.ingest.stop()
+        for thread in self.spi_threads:
+            if thread.is_alive():
+                thread.join(timeout=1.0)
+        # Workers stop after the SPI threads, which read their pipes
+        if self.execution == 'processes':
+            for zone in self.zones.values():
+                zone.buffer.stop_worker()
         
         # Clear LEDs
-        self.spi.clear_strip()
-        self.spi.update_strip(sleep_duration=self.latch_delay)
+        for chain in self.chains:
+            chain.clear()
         
         logger.info("LED controller stopped")
     
-    def set_brightness(self, brightness: int):
-        """Set global brightness for all strips"""
+    @staticmethod
+    def _clamp_brightness(brightness: int) -> int:
         if not 0 <= brightness <= 255:
             logger.warning(f"Brightness {brightness} out of range, clamping to 0-255")
             brightness = max(0, min(255, brightness))
-        
+        return brightness
+    
+    def set_brightness(self, brightness: int):
+        """Set global brightness for all strips"""
+        brightness = self._clamp_brightness(brightness)
         self.brightness = brightness
-        self._brightness_factor = brightness / 255.0
-        
-        if self.cap_pattern:
-            self.cap_pattern.set_brightness(self._brightness_factor)
-        if self.stem_pattern:
-            self.stem_pattern.set_brightness(self._brightness_factor)
+        for zone in self.zones.values():
+            zone.output.set_brightness(brightness)
         
         logger.info(f"Set global brightness to {brightness}")
     
-    def set_cap_brightness(self, brightness: int):
-        """Set brightness for cap only"""
-        if self.cap_pattern:
-            self.cap_pattern.set_brightness(brightness / 255.0)
+    def set_zone_brightness(self, name: str, brightness: int):
+        """Set brightness for one zone (overrides global until next set_brightness)"""
+        self.zone(name).output.set_brightness(self._clamp_brightness(brightness))
+    
+    def _pattern_alive(self, zone: Zone) -> bool:
+        if self.execution == 'processes':
+            return zone.buffer.is_alive()
+        if self.ingest:
+            return self.ingest.is_alive()
+        return self.render_pool.is_alive()
+    
+    def _rate(self, index: int, rates: list, counts: list) -> float:
+        """Rate over chain index's last full second, decaying toward 0 once it stops counting"""
+        elapsed = time.time() - self._fps_since[index]
+        if elapsed >= STALL_SECONDS:
+            return counts[index] / elapsed
+        return rates[index]
     
-    def set_stem_brightness(self, brightness: int):
-        """Set brightness for stem only"""
-        if self.stem_pattern:
-            self.stem_pattern.set_brightness(brightness / 255.0)
+    def fps_of(self, index: int) -> float:
+        """
+        Frame rate of chain index: frames sent plus unchanged frames not retransmitted
+        
+        A static look holds its rate; a chain that has stopped cycling (a
+        stalled thread or bus) decays toward 0 instead of holding its last rate.
+        """
+        return self._rate(index, self.chain_fps, self._fps_frames)
+    
+    def transmit_fps_of(self, index: int) -> float:
+        """Frames actually transmitted per second on chain index (low for static looks)"""
+        return self._rate(index, self.chain_transmit_fps, self._fps_sent)
+    
+    def stalled(self, index: int) -> bool:
+        """Chain index's thread has died, or missed its frame deadline by STALL_SECONDS"""
+        alive = index < len(self.spi_threads) and self.spi_threads[index].is_alive()
+        return self.running and (not alive or time.time() - self._last_cycle_at[index] >= STALL_SECONDS)
+    
+    @property
+    def stalled_chains(self) -> list:
+        return [chain.device_path for index, chain in enumerate(self.chains) if self.stalled(index)]
+    
+    @property
+    def current_fps(self) -> float:
+        """Frame rate of the slowest chain"""
+        return min(self.fps_of(index) for index in range(len(self.chains)))
+    
+    @property
+    def frames_sent(self) -> int:
+        """Frames transmitted by the chain that has sent fewest"""
+        return min(self.chain_frames_sent)
     
     def get_health(self) -> Dict[str, Any]:
         """Get health status of all components"""
+        spi_alive = [index < len(self.spi_threads) and self.spi_threads[index].is_alive()
+                     for index in range(len(self.chains))]
         return {
             'running': self.running,
-            'cap': {
-                'pattern_alive': self.cap_thread.is_alive() if self.cap_thread else False,
-                'spi_alive': self.spi_thread.is_alive() if self.spi_thread else False,
-                'fps': self.current_fps,
-                'frames_generated': 0,
-                'pattern_errors': 0,
-                'spi_errors': 0
+            'zones': {
+                zone.name: {
+                    'pattern_alive': self._pattern_alive(zone),
+                    'spi_alive': spi_alive[self.zone_chains[zone.name]],
+                    'stalled': self.stalled(self.zone_chains[zone.name]),
+                    'fps': self.fps_of(self.zone_chains[zone.name]),
+                    'frames_generated': zone.frames_generated,
+                    'pattern_errors': zone.consecutive_errors,
+                    'spi_errors': self.spi_consecutive_errors[self.zone_chains[zone.name]]
+                }
+                for zone in self.zones.values()
             },
-            'stem': {
-                'pattern_alive': self.stem_thread.is_alive() if self.stem_thread else False,
-                'spi_alive': self.spi_thread.is_alive() if self.spi_thread else False,
-                'fps': self.current_fps,
-                'frames_generated': 0,
-                'pattern_errors': 0,
-                'spi_errors': 0
+            'chains': {
+                chain.device_path: {
+                    'spi_alive': spi_alive[index],
+                    'stalled': self.stalled(index),
+                    'fps': self.fps_of(index),
+                    'transmit_fps': self.transmit_fps_of(index),
+                    'spi_errors': self.spi_consecutive_errors[index]
+                }
+                for index, chain in enumerate(self.chains)
             },
             'total_leds': self.total_leds
         }
     
     def get_stats(self) -> Dict[str, Any]:
         """Get performance statistics"""
-        return {
-            'cap_fps': self.current_fps,
-            'stem_fps': self.current_fps,
-            'cap_frames': self.frames_sent,
-            'stem_frames': self.frames_sent,
-            'cap_errors': 0,
-            'stem_errors': 0
+        if self.render_pool:
+            pattern_latency = [self.render_pool.latency]
+        else:
+            pattern_latency = [zone.latency for zone in self.zones.values()]
+        stats = {
+            'fps': self.current_fps,
+            'frames': self.frames_sent,
+            'errors': sum(zone.errors for zone in self.zones.values()),
+            'frames_skipped': sum(chain.frames_skipped for chain in self.chains),
+            'chains': {
+                chain.device_path: {
+                    'fps': self.fps_of(index),
+                    'transmit_fps': self.transmit_fps_of(index),
+                    'frames': self.chain_frames_sent[index],
+                    'frames_skipped': chain.frames_skipped
+                }
+                for index, chain in enumerate(self.chains)
+            },
+            'spi_wakeup_mean_ms': max(chain.wakeup_latency.mean_ms for chain in self.chains),
+            'spi_wakeup_max_ms': max(chain.wakeup_latency.max_ms for chain in self.chains),
+            'pattern_wakeup_mean_ms': max(latency.mean_ms for latency in pattern_latency),
+            'pattern_wakeup_max_ms': max(latency.max_ms for latency in pattern_latency),
+            'zones': {
+                zone.name: {
+                    'errors': zone.errors,
+                    'dropped': zone.buffer.frames_dropped,
+                    'repeated': zone.buffer.frames_repeated,
+                    'generation_ms': zone.last_generation_ms,
+                    'quality': zone.budget.quality,
+                    'frames_missed': zone.budget.frames_missed,
+                    'output_ratio': zone.interpolator.output_ratio if zone.interpolator else None
+                }
+                for zone in self.zones.values()
+            }
         }
+        if self.power:
+            stats['power'] = self.power.stats()
+        if self.ingest:
+            stats['ingest'] = {
+                'protocol': self.ingest.protocol,
+                'packets': self.ingest.packets_received,
+                'frames': self.ingest.frames_completed,
+                'partial_frames': self.ingest.frames_partial,
+                'dropped': self.ingest.packets_dropped,
+                'ignored': self.ingest.packets_ignored
+            }
+        return stats
     
     def cleanup(self):
         """Clean shutdown of all resources"""
@@ -257,112 +647,72 @@ class LEDController:
         # Stop if running
         self.stop()
         
-        # Close SPI device (Pi5Neo library lacks cleanup, so we access spidev directly)
-        if hasattr(self.spi, 'spi') and self.spi.spi:
-            self.spi.spi.close()
+        for chain in self.chains:
+            chain.close()
+        if self.ingest:
+            self.ingest.close()
+        if self.execution == 'processes':
+            for zone in self.zones.values():
+                zone.buffer.close()
         
         logger.info("LED controller cleanup complete")
     
-    def _cap_pattern_thread(self):
-        """Thread function for cap pattern generation"""
-        logger.debug("Cap pattern thread started")
+    def _spi_thread(self, index: int, chain: OutputChain):
+        """Thread function for one SPI chain's encode and transmission"""
+        logger.debug(f"SPI thread for {chain.device_path} started")
+        self.thread_profiles['spi'].apply()
+        barrier_histogram = self.barrier_histograms[index]
         
         while self.running:
             try:
-                self.cap_consumed.wait(timeout=0.1)
+                wait_start = time.time()
+                self.frame_barrier.wait(timeout=1.0)
+                barrier_histogram.record((time.time() - wait_start) * 1000)
+            except threading.BrokenBarrierError:
                 if not self.running:
                     break
-                self.cap_consumed.clear()
-                
-                gen_start = time.time()
-                pixels = self.cap_pattern.render()
-                self.last_cap_generation_ms = (time.time() - gen_start) * 1000
-                
-                with self.cap_buffer_lock:
-                    self.cap_buffer[:] = pixels
-                
-                self.cap_ready.set()
-                
-            except Exception as e:
-                logger.error(f"Cap pattern error: {e}")
-                time.sleep(0.1)
-        
-        logger.debug("Cap pattern thread exited")
-    
-    def _stem_pattern_thread(self):
-        """Thread function for stem pattern generation"""
-        logger.debug("Stem pattern thread started")
-        
-        while self.running:
+                logger.error(f"SPI frame barrier broken on {chain.device_path}")
+                self.frame_barrier.reset()
+                continue
+            
             try:
-                self.stem_consumed.wait(timeout=0.1)
-                if not self.running:
-                    break
-                self.stem_consumed.clear()
+                # Read before sending so a frame completing mid-send is not missed
+                ingest_seen = self.ingest.frame_sequence if self.ingest else 0
+                sent = chain.send_frame()
+                self.spi_consecutive_errors[index] = 0
+                self._count_frame(index, sent)
+                if not sent:
+                    if self.ingest:
+                        # Transmit as soon as the next network frame is complete
+                        self.ingest.wait_frame(ingest_seen, self.render_interval)
+                        continue
+                    # Nothing changed: idle for a render slot instead of spinning
+                    chain.wakeup_latency.sleep_until(time.time() + self.render_interval)
+                    continue
                 
-                gen_start = time.time()
-                pixels = self.stem_pattern.render()
-                self.last_stem_generation_ms = (time.time() - gen_start) * 1000
-                
-                with self.stem_buffer_lock:
-                    self.stem_buffer[:] = pixels
-                
-                self.stem_ready.set()
+                if self.first_frame_at is None:
+                    self.first_frame_at = time.monotonic()
                 
             except Exception as e:
-                logger.error(f"Stem pattern error: {e}")
+                self.spi_errors[index] += 1
+                self.spi_consecutive_errors[index] += 1
+                logger.error(f"SPI thread error on {chain.device_path}: {e}")
                 time.sleep(0.1)
         
-        logger.debug("Stem pattern thread exited")
+        logger.debug(f"SPI thread for {chain.device_path} exited")
     
-    def _spi_thread(self):
-        """Thread function for SPI transmission"""
-        logger.debug("SPI thread started")
-        
-        while self.running:
-            try:
-                wait_start = time.time()
-                self.cap_ready.wait(timeout=0.1)
-                self.stem_ready.wait(timeout=0.1)
-                self.last_pattern_wait_ms = (time.time() - wait_start) * 1000
-                
-                if not self.running:
-                    break
-                
-                self.cap_ready.clear()
-                self.stem_ready.clear()
-                
-                copy_start = time.time()
-                with self.cap_buffer_lock:
-                    cap_pixels = self.cap_buffer.copy()
-                with self.stem_buffer_lock:
-                    stem_pixels = self.stem_buffer.copy()
-                
-                for i in range(self.cap_led_count):
-                    r, g, b = cap_pixels[i]
-                    self.spi.set_led_color(i, r, g, b)
-                
-                for i in range(self.stem_led_count):
-                    r, g, b = stem_pixels[i]
-                    self.spi.set_led_color(self.cap_led_count + i, r, g, b)
-                self.last_buffer_prep_ms = (time.time() - copy_start) * 1000
-                
-                spi_start = time.time()
-                self.spi.update_strip(sleep_duration=self.latch_delay)
-                self.last_spi_transmit_ms = (time.time() - spi_start) * 1000
-                
-                self.cap_consumed.set()
-                self.stem_consumed.set()
-                
-                self.frames_sent += 1
-                current_time = time.time()
-                if current_time - self.last_fps_time >= 1.0:
-                    self.current_fps = self.frames_sent / (current_time - self.last_fps_time)
-                    self.frames_sent = 0
-                    self.last_fps_time = current_time
-                
-            except Exception as e:
-                logger.error(f"SPI thread error: {e}")
-                time.sleep(0.1)
-        
-        logger.debug("SPI thread exited")
+    def _count_frame(self, index: int, sent: bool):
+        """Count one completed frame cycle of chain index (its thread only)"""
+        current_time = time.time()
+        self._last_cycle_at[index] = current_time
+        self._fps_frames[index] += 1
+        if sent:
+            self.chain_frames_sent[index] += 1
+            self._fps_sent[index] += 1
+        elapsed = current_time - self._fps_since[index]
+        if elapsed >= 1.0:
+            self.chain_fps[index] = self._fps_frames[index] / elapsed
+            self.chain_transmit_fps[index] = self._fps_sent[index] / elapsed
+            self._fps_frames[index] = 0
+            self._fps_sent[index] = 0
+            self._fps_since[index] = current_time
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Output Chain - One SPI bus with its zones in wire order
+Each chain owns an encoder and transmitter sized to its own LED count, so
+chains on separate buses can be encoded and sent in parallel
+"""
+
+import logging
+import time
+import numpy as np
+from typing import List, Optional, Tuple
+from .frame_buffer import ZoneBuffer
+from .interpolator import FrameInterpolator
+from .power import PowerZone
+from .output_lut import OutputLUT
+from .ws2811_encoder import WS2811Encoder, BYTES_PER_LED
+from .spi_transmitter import SPITransmitter
+from .virtual_spi import VirtualSPITransmitter
+from .realtime import LatencyTracker, ThreadProfile
+from monitoring import MetricsRegistry
+
+logger = logging.getLogger(__name__)
+
+# hardware.spi_backend -> transmitter class
+SPI_BACKENDS = {
+    'spidev': SPITransmitter,
+    'virtual': VirtualSPITransmitter,
+}
+
+
+class OutputChain:
+    """Series-wired LED zones on a single SPI device"""
+
+    def __init__(self, device_path: str, speed_hz: int, color_order: str,
+                 streaming: bool, latch_delay: float, keepalive_interval: float,
+                 backend: str, metrics: MetricsRegistry, thread_profile: Optional[ThreadProfile] = None):
+        if backend not in SPI_BACKENDS:
+            raise ValueError(f"Unknown SPI backend '{backend}', must be one of {sorted(SPI_BACKENDS)}")
+
+        self.device_path = device_path
+        self.backend = backend
+        self.speed_hz = speed_hz
+        self.color_order = color_order
+        self.streaming = streaming
+        self.latch_delay = latch_delay
+        self.keepalive_interval = keepalive_interval
+        self.thread_profile = thread_profile
+
+        # (zone buffer, output LUT, LED offset within this chain) in wire order
+        self.zones: List[Tuple[ZoneBuffer, OutputLUT, int]] = []
+        # Per zone, a FrameInterpolator blending between rendered frames, or None
+        self.interpolators: List[Optional[FrameInterpolator]] = []
+        # Per zone, its PowerZone when power limiting is on, or None
+        self.power_zones: List[Optional[PowerZone]] = []
+        self._rails = []
+        self.led_count = 0
+
+        # Latency histograms, recorded only by this chain's SPI thread
+        self.metrics = metrics
+        self._handoff_histograms = []
+        self.encode_histogram = metrics.histogram(
+            'encode_ms', "Bitstream encode time per frame", chain=device_path)
+        self.transmit_histogram = metrics.histogram(
+            'transmit_ms', "SPI transmit and latch time per frame", chain=device_path)
+
+        self.encoder = None
+        self.transmitter = None
+
+        # What is on the wire: per-zone source pixels and LUT version last sent
+        self._sent_pixels = []
+        self._sent_versions = []
+        self._acquired = []
+        self._fresh = []
+        self._last_send_time = 0.0
+
+        # Timing metrics (last frame only)
+        self.last_encode_ms = 0
+        self.last_transmit_ms = 0
+        self.frames_skipped = 0
+        self.wakeup_latency = LatencyTracker()
+
+    def add_zone(self, name: str, zone_buffer: ZoneBuffer, output_lut: OutputLUT,
+                 chain_offset: Optional[int] = None, interpolator: Optional[FrameInterpolator] = None,
+                 power: Optional[PowerZone] = None):
+        """
+        Append a zone and its output correction to the chain
+
+        Args:
+            chain_offset: LEDs on the chain before this zone, or None to follow
+                          the previous zone directly; LEDs in a gap stay dark
+            interpolator: Blends the zone's frames at the transmit rate, or None
+                          to send each rendered frame as is
+            power: Estimates the zone's draw and limits it to its rail's
+                   budget, or None for no limiting
+        """
+        if self.transmitter is not None:
+            raise RuntimeError("Cannot add zones after the chain is opened")
+        if chain_offset is None:
+            chain_offset = self.led_count
+        if chain_offset < self.led_count:
+            raise ValueError(f"Zone {name} at chain offset {chain_offset} overlaps the "
+                             f"{self.led_count} LEDs before it on {self.device_path}")
+        self.zones.append((zone_buffer, output_lut, chain_offset))
+        self.interpolators.append(interpolator)
+        self.power_zones.append(power)
+        # The first chain with a zone on a rail updates it; the others only read its scale
+        if power is not None and power.rail.owner is None:
+            power.rail.owner = self
+            self._rails.append(power.rail)
+        self._handoff_histograms.append(self.metrics.histogram(
+            'handoff_ms', "Age of a new frame when the SPI thread picks it up", zone=name))
+        self.led_count = chain_offset + zone_buffer.count
+
+    def open(self):
+        """Allocate the bitstream buffer, open the device and blank the chain"""
+        if not self.zones:
+            raise RuntimeError(f"Chain on {self.device_path} has no zones")
+
+        self.encoder = WS2811Encoder(self.led_count, self.color_order)
+        self._sent_pixels = [np.zeros((zone_buffer.count, 3), dtype=np.uint8)
+                             for zone_buffer, _, _ in self.zones]
+        self._sent_versions = [-1] * len(self.zones)
+        self._acquired = [None] * len(self.zones)
+        self._fresh = [False] * len(self.zones)
+        self.transmitter = SPI_BACKENDS[self.backend](
+            self.device_path,
+            self.speed_hz,
+            self.encoder.buffer,
+            streaming=self.streaming,
+            thread_profile=self.thread_profile
+        )
+        self.clear()
+        logger.info(f"Output chain on {self.device_path}: {len(self.zones)} zone(s), {self.led_count} LEDs")
+
+    def send_frame(self) -> bool:
+        """
+        Encode every zone's freshest frame in wire order and send it
+
+        With streaming on, each bufsiz chunk goes out as soon as it is encoded,
+        so earlier zones are already on the wire while later ones are encoded.
+
+        The frame is skipped when every zone's pixels and output LUT match what
+        was last sent, since the encoded bitstream would be identical. A
+        keep-alive resend still goes out every keepalive_interval seconds.
+        Dithered outputs change every frame and are never skipped.
+
+        Returns:
+            True if the frame was transmitted, False if it was skipped
+        """
+        encode_start = time.time()
+        for index, (zone_buffer, output_lut, _) in enumerate(self.zones):
+            pixels, fresh = zone_buffer.acquire()
+            if fresh:
+                self._handoff_histograms[index].record((encode_start - zone_buffer.front_published_at) * 1000)
+            interpolator = self.interpolators[index]
+            if interpolator is not None:
+                if fresh:
+                    interpolator.push(pixels, zone_buffer.front_published_at)
+                pixels, fresh = interpolator.sample(encode_start)
+            self._acquired[index] = pixels
+            self._fresh[index] = fresh
+            if self.power_zones[index] is not None:
+                self.power_zones[index].estimate(pixels, output_lut, fresh)
+
+        # Rail limits land in the LUTs before the change check, so a new scale is sent
+        for rail in self._rails:
+            rail.update()
+        for index, (_, output_lut, _) in enumerate(self.zones):
+            if self.power_zones[index] is not None:
+                output_lut.set_power_scale(self.power_zones[index].rail.scale)
+
+        changed = encode_start - self._last_send_time >= self.keepalive_interval
+        for index, (_, output_lut, _) in enumerate(self.zones):
+            if changed:
+                break
+            if (output_lut.dithering or output_lut.version != self._sent_versions[index]
+                    or (self._fresh[index] and not np.array_equal(self._acquired[index], self._sent_pixels[index]))):
+                changed = True
+
+        if not changed:
+            self.frames_skipped += 1
+            return False
+
+        if self.streaming:
+            self.transmitter.begin_frame()
+        for index, (zone_buffer, output_lut, chain_start) in enumerate(self.zones):
+            pixels = self._acquired[index]
+            # Read the version before encoding so a concurrent LUT swap forces a resend
+            self._sent_versions[index] = output_lut.version
+            output_lut.encode(self.encoder, pixels, chain_start)
+            np.copyto(self._sent_pixels[index], pixels)
+            if self.streaming:
+                self.transmitter.encoded((chain_start + zone_buffer.count) * BYTES_PER_LED)
+        self.last_encode_ms = (time.time() - encode_start) * 1000
+        self.encode_histogram.record(self.last_encode_ms)
+
+        spi_start = time.time()
+        if self.streaming:
+            self.transmitter.finish_frame()
+        else:
+            self.transmitter.send()
+        self.wakeup_latency.sleep_until(time.time() + self.latch_delay)
+        self._last_send_time = time.time()
+        self.last_transmit_ms = (self._last_send_time - spi_start) * 1000
+        self.transmit_histogram.record(self.last_transmit_ms)
+        return True
+
+    def clear(self):
+        """Send an all-off frame"""
+        self._sent_versions = [-1] * len(self.zones)
+        self.encoder.clear()
+        self.transmitter.send()
+        time.sleep(self.latch_delay)
+
+    def close(self):
+        """Close the SPI device"""
+        if self.transmitter is not None:
+            self.transmitter.close()
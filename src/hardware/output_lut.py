@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""
+Output LUT - Gamma, brightness and white balance applied just before encoding
+Each zone's correction is a per-channel 256-entry table composed with the
+bitstream table, so correction costs nothing beyond the encoder's own lookup
+"""
+
+import numpy as np
+from typing import NamedTuple, Optional, Sequence
+from .ws2811_encoder import WS2811Encoder
+
+# Corrected levels are 8.8 fixed point: integer output byte plus 8 bits of dither fraction
+LEVEL_ONE = 255 << 8
+
+
+def build_levels(gamma: float, brightness: int, white_balance: Sequence[float]) -> np.ndarray:
+    """
+    Build per-channel correction tables
+
+    Returns:
+        uint16 array of shape (3, 256) with 8.8 fixed point output levels
+    """
+    curve = (np.arange(256, dtype=np.float64) / 255.0) ** gamma
+    scale = (brightness / 255.0) * np.asarray(white_balance, dtype=np.float64)
+    levels = np.rint(curve[np.newaxis, :] * scale[:, np.newaxis] * LEVEL_ONE)
+    return np.clip(levels, 0, LEVEL_ONE).astype(np.uint16)
+
+
+class LUTState(NamedTuple):
+    """Tables for one brightness and power scale, swapped in as a unit"""
+    brightness: int
+    power_scale: float
+    levels: np.ndarray
+    bitstream: np.ndarray
+    duty: np.ndarray
+
+
+class OutputLUT:
+    """
+    Per-zone output correction, rebuilt only when brightness or power scale changes
+
+    The power scale (set by the power limiter, 1.0 = unlimited) multiplies
+    brightness in the tables. duty holds the unlimited output level of each
+    input value, so a frame's current draw is a histogram dot product
+    (output_sum) instead of a pass over the corrected frame.
+
+    Brightness is set from the control or main thread and the power scale
+    from the SPI thread, so neither writes the tables directly: each records
+    its request and rebuilds a LUTState from both, and whichever rebuild
+    swaps in last re-checks the requests and builds again if it raced.
+    """
+
+    def __init__(self, led_count: int, gamma: float, white_balance: Sequence[float],
+                 brightness: int, dithering: bool):
+        if gamma <= 0:
+            raise ValueError(f"Gamma must be positive, got {gamma}")
+        if len(white_balance) != 3 or any(not 0.0 <= w <= 1.0 for w in white_balance):
+            raise ValueError(f"White balance must be 3 values in 0-1, got {white_balance}")
+
+        self.led_count = led_count
+        self.gamma = gamma
+        self.white_balance = tuple(white_balance)
+        self.dithering = dithering
+        # Requested settings; state holds the ones the tables were built for
+        self._brightness = brightness
+        self._power_scale = 1.0
+        self.state: Optional[LUTState] = None
+
+        # Temporal dithering carries each pixel's dropped fraction into the next frame
+        if dithering:
+            self._residual = np.zeros((led_count, 3), dtype=np.uint16)
+            self._accum = np.zeros((led_count, 3), dtype=np.uint16)
+            self._output = np.zeros((led_count, 3), dtype=np.uint8)
+
+        # Bumped on every table swap so outputs can tell the encoding changed
+        self.version = 0
+        self.set_brightness(brightness)
+
+    @property
+    def brightness(self) -> int:
+        """Brightness of the tables in use"""
+        return self.state.brightness
+
+    @property
+    def power_scale(self) -> float:
+        """Power scale of the tables in use"""
+        return self.state.power_scale
+
+    @property
+    def duty(self) -> np.ndarray:
+        """Output fraction per channel and input value before power limiting"""
+        return self.state.duty
+
+    def set_brightness(self, brightness: int):
+        """Rebuild tables for a new brightness (0-255); swapped in atomically"""
+        if not 0 <= brightness <= 255:
+            raise ValueError(f"Brightness must be 0-255, got {brightness}")
+        self._brightness = brightness
+        self._build()
+
+    def set_power_scale(self, scale: float):
+        """Limit output to scale (0-1) of brightness; rebuilt only in 1/256 steps"""
+        scale = round(min(max(scale, 0.0), 1.0) * 256) / 256
+        if scale == self._power_scale:
+            return
+        self._power_scale = scale
+        self._build()
+
+    def _build(self):
+        """Swap in tables for the requested settings, rebuilding if a request changed meanwhile"""
+        while True:
+            brightness, scale = self._brightness, self._power_scale
+            current = self.state
+            if current is not None and (current.brightness, current.power_scale) == (brightness, scale):
+                return
+            if current is not None and current.brightness == brightness:
+                duty = current.duty
+            else:
+                duty = build_levels(self.gamma, brightness, self.white_balance) / LEVEL_ONE
+            levels = build_levels(self.gamma, brightness * scale, self.white_balance)
+            rounded = np.minimum((levels.astype(np.uint32) + 128) >> 8, 255)
+            self.state = LUTState(brightness, scale, levels, WS2811Encoder.TABLE[rounded], duty)
+            self.version += 1
+            if (self._brightness, self._power_scale) == (brightness, scale):
+                return
+
+    def output_sum(self, pixels: np.ndarray, duty: Optional[np.ndarray] = None) -> float:
+        """
+        Summed unlimited output of every channel of pixels (1.0 = one channel fully on)
+
+        A pass of its own over pixels (a histogram per channel against the duty
+        table), run for the power estimate before encode(); it does not see the
+        encoded bitstream or dithering. Pass duty from one read of the state to
+        measure against a known brightness.
+        """
+        if duty is None:
+            duty = self.state.duty
+        total = 0.0
+        for channel in range(3):
+            total += float(np.bincount(pixels[:, channel], minlength=256) @ duty[channel])
+        return total
+
+    def encode(self, encoder: WS2811Encoder, pixels: np.ndarray, start: int):
+        """Correct and encode pixels into the encoder's buffer at start"""
+        state = self.state
+        levels, bitstream = state.levels, state.bitstream
+        if not self.dithering:
+            encoder.encode(pixels, start, tables=bitstream)
+            return
+
+        count = pixels.shape[0]
+        accum = self._accum[:count]
+        residual = self._residual[:count]
+        output = self._output[:count]
+        for channel in range(3):
+            np.take(levels[channel], pixels[:, channel], out=accum[:, channel], mode='clip')
+        accum += residual
+        np.bitwise_and(accum, 0xFF, out=residual)
+        np.right_shift(accum, 8, out=accum)
+        output[:] = accum
+        encoder.encode(output, start)
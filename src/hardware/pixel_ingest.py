@@ -0,0 +1,483 @@
+#!/usr/bin/env python3
+"""
+Pixel Ingest - Network pixel sources (E1.31 sACN, Art-Net, DDP) in place of patterns
+Packets arrive in batches via recvmmsg into one preallocated buffer, their
+headers are parsed for the whole batch at once, and pixel data is copied
+straight into the zones' back slots: sequence-gated and gathered as arrays
+when the batch holds at most one frame boundary, at its end, and packet by
+packet (a few Python objects each) when frames complete mid-batch. A completed frame publishes every zone
+and bumps a sequence number the SPI threads wait on, so transmission starts
+as soon as the sender's frame is whole.
+"""
+
+import ctypes
+import logging
+import select
+import socket
+import threading
+import time
+import numpy as np
+from typing import Any, Dict, List, Optional
+from .realtime import ThreadProfile
+from .zone import Zone
+
+logger = logging.getLogger(__name__)
+
+# Default UDP port per protocol
+PROTOCOLS = {'e131': 5568, 'artnet': 6454, 'ddp': 4048}
+
+# Largest datagram kept; E1.31 is 638 bytes, Art-Net 530, DDP 1450 with timecode
+MAX_PACKET = 1500
+
+# Art-Net and E1.31 both fall back to frame-by-universe completion this long after the last sync
+SYNC_TIMEOUT = 4.0
+
+E131_IDENTIFIER = np.frombuffer(b'ASC-E1.17\x00\x00\x00', dtype=np.uint8)
+E131_ROOT_DATA = 0x00000004
+E131_ROOT_EXTENDED = 0x00000008
+E131_FRAMING_SYNC = 0x00000001
+E131_DATA = 126             # First DMX slot after the start code
+
+ARTNET_IDENTIFIER = np.frombuffer(b'Art-Net\x00', dtype=np.uint8)
+ARTNET_DMX = 0x5000
+ARTNET_SYNC = 0x5200
+ARTNET_DATA = 18
+
+DDP_VERSION_1 = 0x40
+DDP_TIMECODE = 0x10
+DDP_PUSH = 0x01
+DDP_DISPLAY = 1             # Default output device id
+DDP_HEADER = 10
+
+# Packet kinds after header parsing
+IGNORED, DATA, SYNC = 0, 1, 2
+
+MSG_DONTWAIT = 0x40
+
+
+class _IOVec(ctypes.Structure):
+    _fields_ = [('iov_base', ctypes.c_void_p), ('iov_len', ctypes.c_size_t)]
+
+
+class _MsgHdr(ctypes.Structure):
+    _fields_ = [('msg_name', ctypes.c_void_p), ('msg_namelen', ctypes.c_uint32),
+                ('msg_iov', ctypes.POINTER(_IOVec)), ('msg_iovlen', ctypes.c_size_t),
+                ('msg_control', ctypes.c_void_p), ('msg_controllen', ctypes.c_size_t),
+                ('msg_flags', ctypes.c_int)]
+
+
+class _MMsgHdr(ctypes.Structure):
+    _fields_ = [('msg_hdr', _MsgHdr), ('msg_len', ctypes.c_uint)]
+
+
+def _load_recvmmsg():
+    """libc recvmmsg (Linux); loaded on first open so the module imports anywhere"""
+    recvmmsg = ctypes.CDLL(None, use_errno=True).recvmmsg
+    recvmmsg.argtypes = [ctypes.c_int, ctypes.POINTER(_MMsgHdr), ctypes.c_uint, ctypes.c_int, ctypes.c_void_p]
+    recvmmsg.restype = ctypes.c_int
+    return recvmmsg
+
+
+def _be16(packets: np.ndarray, offset: int) -> np.ndarray:
+    return (packets[:, offset].astype(np.int64) << 8) | packets[:, offset + 1]
+
+
+def _be32(packets: np.ndarray, offset: int) -> np.ndarray:
+    return (_be16(packets, offset) << 16) | _be16(packets, offset + 2)
+
+
+class PixelIngest:
+    """
+    Receives one network pixel stream and writes it into the zones' frames
+
+    Channels are addressed across all zones in strips list order (zone 0's
+    first LED is channel 0). E1.31 and Art-Net universe u carries
+    channels_per_universe channels starting at
+    (u - start_universe) * channels_per_universe; DDP offsets are channels.
+
+    A frame is complete on a DDP push flag, on an E1.31 or Art-Net sync
+    packet once the sender uses them, and otherwise when every universe has
+    arrived (or one arrives twice, meaning the sender moved on). Channels
+    not received for a frame keep their previous values. Packets older than
+    their universe's last sequence number are dropped.
+    """
+
+    def __init__(self, zones: List[Zone], config: Dict[str, Any], thread_profile: Optional[ThreadProfile] = None):
+        """
+        Args:
+            zones: Zones with ZoneBuffers from the shared FrameBuffer, in wire order
+            config: The ingest section of led_config.yaml
+            thread_profile: ThreadProfile the receive thread applies to itself
+        """
+        for key in ('protocol', 'bind', 'port', 'multicast', 'start_universe',
+                    'channels_per_universe', 'batch_packets'):
+            if key not in config:
+                raise ValueError(f"Config missing 'ingest.{key}'")
+        self.protocol = config['protocol']
+        if self.protocol not in PROTOCOLS:
+            raise ValueError(f"ingest.protocol must be one of {list(PROTOCOLS)}, got '{self.protocol}'")
+        self.bind = config['bind']
+        self.port = config['port'] if config['port'] else PROTOCOLS[self.protocol]
+        self.multicast = config['multicast']
+        self.start_universe = config['start_universe']
+        self.channels_per_universe = config['channels_per_universe']
+        if not 1 <= self.channels_per_universe <= 512:
+            raise ValueError(f"ingest.channels_per_universe must be 1-512, got {self.channels_per_universe}")
+        self.batch_packets = config['batch_packets']
+        if self.batch_packets <= 0:
+            raise ValueError(f"ingest.batch_packets must be positive, got {self.batch_packets}")
+        self.thread_profile = thread_profile
+
+        # Channel range of each zone in the ingest address space
+        self.zones = zones
+        self._zone_starts = []
+        channel = 0
+        for zone in zones:
+            self._zone_starts.append(channel)
+            channel += zone.led_count * 3
+        self.total_channels = channel
+        self.universe_count = -(-self.total_channels // self.channels_per_universe)
+
+        # Receive buffers, reused for every batch
+        self._packets = np.zeros((self.batch_packets, MAX_PACKET), dtype=np.uint8)
+        self._iovecs = (_IOVec * self.batch_packets)()
+        self._messages = (_MMsgHdr * self.batch_packets)()
+        base = self._packets.ctypes.data
+        for index in range(self.batch_packets):
+            self._iovecs[index].iov_base = base + index * MAX_PACKET
+            self._iovecs[index].iov_len = MAX_PACKET
+            self._messages[index].msg_hdr.msg_iov = ctypes.pointer(self._iovecs[index])
+            self._messages[index].msg_hdr.msg_iovlen = 1
+        self._lengths = np.ndarray((self.batch_packets,), dtype=np.uint32, buffer=self._messages,
+                                   offset=_MMsgHdr.msg_len.offset, strides=(ctypes.sizeof(_MMsgHdr),))
+
+        # Frame assembly: channels written since the last publish, and universes seen
+        self._covered = np.zeros(self.total_channels, dtype=bool)
+        self._universes = np.zeros(self.universe_count, dtype=bool)
+        self._universes_seen = 0
+        self._sequences = np.full(max(self.universe_count, 1), -1, dtype=np.int16)
+        self._last_sync = float('-inf')
+
+        # Completed frames; SPI threads wait on this (wait_frame)
+        self.frame_sequence = 0
+        self._frame_ready = threading.Condition()
+
+        self.socket: Optional[socket.socket] = None
+        self._recvmmsg = None
+        self.running = False
+        self.thread: Optional[threading.Thread] = None
+
+        self.packets_received = 0
+        self.packets_dropped = 0     # Out of sequence
+        self.packets_ignored = 0     # Other protocols, other universes, malformed
+        self.frames_completed = 0
+        self.frames_partial = 0      # Completed with channels carried over from the frame before
+
+    def open(self):
+        """Bind the non-blocking UDP socket"""
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        # Room for a few frames of packets while the receive thread is descheduled
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+        sock.bind((self.bind, self.port))
+        if self.multicast and self.protocol == 'e131':
+            # sACN universe u is multicast to 239.255.(u >> 8).(u & 0xFF)
+            interface = socket.inet_aton('0.0.0.0' if self.bind in ('', '0.0.0.0') else self.bind)
+            for universe in range(self.start_universe, self.start_universe + self.universe_count):
+                group = socket.inet_aton(f"239.255.{universe >> 8}.{universe & 0xFF}")
+                sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, group + interface)
+        sock.setblocking(False)
+        self._recvmmsg = _load_recvmmsg()
+        self.socket = sock
+        logger.info(f"Pixel ingest: {self.protocol} on {self.bind}:{self.port}, {self.total_channels} channels"
+                    + (f" in universes {self.start_universe}-{self.start_universe + self.universe_count - 1}"
+                       if self.protocol != 'ddp' else ""))
+
+    def is_alive(self) -> bool:
+        return self.thread is not None and self.thread.is_alive()
+
+    def start(self):
+        if self.socket is None:
+            self.open()
+        self.running = True
+        self.thread = threading.Thread(target=self._thread, name="pixel-ingest", daemon=True)
+        self.thread.start()
+
+    def stop(self, timeout: float = 1.0):
+        self.running = False
+        if self.thread is not None and self.thread.is_alive():
+            self.thread.join(timeout=timeout)
+        self.thread = None
+        with self._frame_ready:
+            self._frame_ready.notify_all()
+
+    def close(self):
+        self.stop()
+        if self.socket is not None:
+            self.socket.close()
+            self.socket = None
+
+    def wait_frame(self, seen: int, timeout: float) -> int:
+        """Block until a frame newer than sequence seen completes (or timeout); returns the latest sequence"""
+        with self._frame_ready:
+            self._frame_ready.wait_for(lambda: self.frame_sequence != seen or not self.running, timeout)
+            return self.frame_sequence
+
+    def _thread(self):
+        """Receive thread: drain the socket in batches whenever it is readable"""
+        logger.debug("Pixel ingest thread started")
+        if self.thread_profile is not None:
+            self.thread_profile.apply()
+        poller = select.poll()
+        poller.register(self.socket.fileno(), select.POLLIN)
+        fd = self.socket.fileno()
+
+        while self.running:
+            try:
+                if not poller.poll(100):
+                    continue
+                while self.running:
+                    count = self._recvmmsg(fd, self._messages, self.batch_packets, MSG_DONTWAIT, None)
+                    if count <= 0:
+                        break
+                    self.packets_received += count
+                    self._handle_batch(count)
+            except Exception as e:
+                logger.error(f"Pixel ingest error: {e}")
+                time.sleep(0.1)
+
+        logger.debug("Pixel ingest thread exited")
+
+    def _parse(self, packets: np.ndarray, lengths: np.ndarray):
+        """
+        Vectorized header parse of one batch
+
+        Returns:
+            Arrays of kind, universe index (-1 for none), sequence (-1 for none),
+            destination channel, data offset in the packet, channel count, DDP push flag
+        """
+        count = packets.shape[0]
+        lengths = lengths.astype(np.int64)
+        kind = np.full(count, IGNORED, dtype=np.int8)
+        universe = np.full(count, -1, dtype=np.int64)
+        sequence = np.full(count, -1, dtype=np.int64)
+        channel = np.zeros(count, dtype=np.int64)
+        offset = np.zeros(count, dtype=np.int64)
+        size = np.zeros(count, dtype=np.int64)
+        push = np.zeros(count, dtype=bool)
+
+        if self.protocol == 'e131':
+            valid = (lengths >= 49) & (packets[:, 4:16] == E131_IDENTIFIER).all(axis=1)
+            root = _be32(packets, 18)
+            sync = valid & (root == E131_ROOT_EXTENDED) & (_be32(packets, 40) == E131_FRAMING_SYNC)
+            # Preview data and stream-terminated packets never reach the LEDs
+            data = (valid & (lengths > E131_DATA) & (root == E131_ROOT_DATA)
+                    & (packets[:, 125] == 0) & ((packets[:, 112] & 0xC0) == 0))
+            universe[data] = _be16(packets, 113)[data] - self.start_universe
+            sequence[data] = packets[data, 111]
+            size[data] = np.minimum(_be16(packets, 123)[data] - 1, lengths[data] - E131_DATA)
+            offset[data] = E131_DATA
+        elif self.protocol == 'artnet':
+            valid = (lengths >= 12) & (packets[:, :8] == ARTNET_IDENTIFIER).all(axis=1)
+            opcode = packets[:, 8].astype(np.int64) | (packets[:, 9].astype(np.int64) << 8)
+            sync = valid & (opcode == ARTNET_SYNC)
+            data = valid & (opcode == ARTNET_DMX) & (lengths > ARTNET_DATA)
+            universe[data] = ((packets[data, 15].astype(np.int64) << 8) | packets[data, 14]) - self.start_universe
+            # Sequence 0 means the sender does not sequence
+            sequence[data] = np.where(packets[data, 12] == 0, -1, packets[data, 12])
+            size[data] = np.minimum(_be16(packets, 16)[data], lengths[data] - ARTNET_DATA)
+            offset[data] = ARTNET_DATA
+        else:
+            flags = packets[:, 0]
+            data = ((lengths >= DDP_HEADER) & ((flags & 0xC0) == DDP_VERSION_1) & ((flags & 0x0E) == 0)
+                    & (packets[:, 3] == DDP_DISPLAY))
+            sync = np.zeros(count, dtype=bool)
+            header = np.where((flags & DDP_TIMECODE) != 0, DDP_HEADER + 4, DDP_HEADER)
+            channel[data] = _be32(packets, 4)[data]
+            size[data] = np.minimum(_be16(packets, 8)[data], lengths[data] - header[data])
+            offset[data] = header[data]
+            push[data] = (flags[data] & DDP_PUSH) != 0
+            # 4-bit sequence, 0 when unused; one stream so one counter
+            sequence[data] = np.where((packets[data, 1] & 0x0F) == 0, -1, packets[data, 1] & 0x0F)
+            universe[data] = 0
+
+        if self.protocol != 'ddp':
+            in_range = data & (universe >= 0) & (universe < self.universe_count)
+            data &= in_range
+            channel[data] = universe[data] * self.channels_per_universe
+            size[data] = np.minimum(size[data], self.channels_per_universe)
+        data &= size > 0
+        kind[data] = DATA
+        kind[sync] = SYNC
+        return kind, universe, sequence, channel, offset, size, push
+
+    def _handle_batch(self, count: int):
+        """
+        Apply one received batch in arrival order
+
+        The packets before the first sync go through _apply_run() as arrays
+        when they hold at most one frame boundary, at their end (a sender's
+        frame arriving together); the rest, and any run that does not fit,
+        through _apply_packets() one packet at a time.
+        """
+        packets = self._packets[:count]
+        parsed = self._parse(packets, self._lengths[:count])
+        syncs = np.flatnonzero(parsed[0] == SYNC)
+        run = int(syncs[0]) if syncs.size else count
+        start = run if run and self._apply_run(packets, parsed, run) else 0
+        if start < count:
+            self._apply_packets(packets, parsed, start)
+
+    def _apply_run(self, packets: np.ndarray, parsed: tuple, stop: int) -> bool:
+        """
+        Apply packets[:stop] (no sync among them) with array operations
+
+        Returns False, having applied nothing, unless the run is in sequence
+        order and completes at most one frame, after its last packet: DDP
+        with no push before the last packet and no overlapping ranges, or
+        universes each arriving at most once (and, without sync, none
+        already in the frame being assembled).
+        """
+        kinds, universes, sequences, channels, offsets, sizes, pushes = (array[:stop] for array in parsed)
+        rows = np.flatnonzero(kinds == DATA)
+        complete = False
+        if self.protocol == 'ddp':
+            if rows.size > 1 and pushes[rows[:-1]].any():
+                return False
+            starts = np.sort(channels[rows])
+            ends = np.sort(channels[rows] + sizes[rows])
+            if (starts[1:] < ends[:-1]).any():
+                return False
+            # One stream: each sequenced packet must be newer than the one before it
+            sequenced = sequences[rows]
+            sequenced = sequenced[sequenced >= 0]
+            previous = np.concatenate((self._sequences[:1].astype(np.int64), sequenced[:-1]))
+            if ((previous >= 0) & ((previous - sequenced) % 16 < 8)).any():
+                return False
+            if sequenced.size:
+                self._sequences[0] = sequenced[-1]
+            complete = rows.size > 0 and bool(pushes[rows[-1]])
+        else:
+            if rows.size and np.bincount(universes[rows], minlength=self.universe_count).max() > 1:
+                return False
+            last = self._sequences[universes[rows]].astype(np.int64)
+            stale = (sequences[rows] >= 0) & (last >= 0) & ((last - sequences[rows]) % 256 < 20)
+            accepted = rows[~stale]
+            arrived = universes[accepted]
+            synced = time.monotonic() - self._last_sync < SYNC_TIMEOUT
+            if not synced:
+                if self._universes[arrived].any():
+                    return False
+                self._universes[arrived] = True
+                self._universes_seen += arrived.size
+                complete = self._universes_seen == self.universe_count
+            self.packets_dropped += int(np.count_nonzero(stale))
+            sequenced = accepted[sequences[accepted] >= 0]
+            self._sequences[universes[sequenced]] = sequences[sequenced]
+            rows = accepted
+
+        self.packets_ignored += stop - int(np.count_nonzero(kinds == DATA))
+        self._write_rows(packets, rows, channels, offsets, sizes)
+        if complete:
+            self._complete()
+        return True
+
+    def _apply_packets(self, packets: np.ndarray, parsed: tuple, start: int):
+        """Apply packets[start:] one at a time (syncs, and frames completing mid-batch)"""
+        rows = zip(*(array[start:].tolist() for array in parsed))
+        for index, (kind, universe, sequence, channel, offset, size, push) in enumerate(rows, start):
+            if kind == SYNC:
+                self._last_sync = time.monotonic()
+                self._complete()
+                continue
+            if kind != DATA:
+                self.packets_ignored += 1
+                continue
+
+            if sequence >= 0:
+                last = int(self._sequences[universe])
+                # E1.31 ordering rule: up to 20 (8 for DDP's 4 bits) behind the last is stale
+                window = 8 if self.protocol == 'ddp' else 20
+                modulus = 16 if self.protocol == 'ddp' else 256
+                if last >= 0 and 0 <= (last - sequence) % modulus < window:
+                    self.packets_dropped += 1
+                    continue
+                self._sequences[universe] = sequence
+
+            synced = time.monotonic() - self._last_sync < SYNC_TIMEOUT
+            if self.protocol != 'ddp' and not synced:
+                if self._universes[universe]:
+                    # The sender started the next frame before this one was whole
+                    self._complete()
+
+            self._write(packets[index], offset, channel, size)
+
+            if self.protocol == 'ddp':
+                if push:
+                    self._complete()
+            elif not synced:
+                if not self._universes[universe]:
+                    self._universes[universe] = True
+                    self._universes_seen += 1
+                if self._universes_seen == self.universe_count:
+                    self._complete()
+
+    def _write(self, packet: np.ndarray, offset: int, channel: int, size: int):
+        """Copy packet[offset:offset + size] to ingest channel, across zone boundaries"""
+        end = min(channel + size, self.total_channels)
+        if channel >= end:
+            return
+        self._covered[channel:end] = True
+        for zone, start in zip(self.zones, self._zone_starts):
+            zone_end = start + zone.led_count * 3
+            if zone_end <= channel:
+                continue
+            if start >= end:
+                break
+            low = max(channel, start)
+            high = min(end, zone_end)
+            zone.buffer.back_channels[low - start:high - start] = packet[offset + low - channel:offset + high - channel]
+
+    def _write_rows(self, packets: np.ndarray, rows: np.ndarray, channels: np.ndarray,
+                    offsets: np.ndarray, sizes: np.ndarray):
+        """_write() of every packet in rows in one gather per zone; their channel ranges must not overlap"""
+        low = channels[rows]
+        lengths = np.maximum(np.minimum(low + sizes[rows], self.total_channels) - low, 0)
+        total = int(lengths.sum())
+        if not total:
+            return
+        within = np.arange(total) - np.repeat(np.cumsum(lengths) - lengths, lengths)
+        destination = np.repeat(low, lengths) + within
+        values = packets[np.repeat(rows, lengths), np.repeat(offsets[rows], lengths) + within]
+        self._covered[destination] = True
+        for zone, start in zip(self.zones, self._zone_starts):
+            inside = (destination >= start) & (destination < start + zone.led_count * 3)
+            zone.buffer.back_channels[destination[inside] - start] = values[inside]
+
+    def _complete(self):
+        """Publish the frame assembled since the last publish"""
+        if not self._covered.any():
+            return
+        if not self._covered.all():
+            # Carry channels the sender did not refresh from the last published frame
+            self.frames_partial += 1
+            edges = np.diff(np.concatenate(([True], self._covered, [True])).astype(np.int8))
+            for low, high in zip(np.flatnonzero(edges == -1).tolist(), np.flatnonzero(edges == 1).tolist()):
+                for zone, start in zip(self.zones, self._zone_starts):
+                    zone_end = start + zone.led_count * 3
+                    if zone_end <= low or start >= high:
+                        continue
+                    a = max(low, start) - start
+                    b = min(high, zone_end) - start
+                    zone.buffer.back_channels[a:b] = zone.buffer.published_channels[a:b]
+
+        for zone in self.zones:
+            zone.buffer.publish()
+            zone.frames_generated += 1
+        self._covered.fill(False)
+        self._universes.fill(False)
+        self._universes_seen = 0
+        self.frames_completed += 1
+        with self._frame_ready:
+            self.frame_sequence += 1
+            self._frame_ready.notify_all()
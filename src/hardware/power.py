@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Power Limiter - Estimated current per zone and supply rail, held under each rail's budget
+Every fresh frame's draw is estimated before it is encoded, by a separate
+histogram pass over its pixels against the LUT's duty table; a rail over budget scales its zones' brightness down at once, then recovers
+gradually, so bright frames dim slightly instead of sagging the supply
+"""
+
+import time
+from typing import Any, Dict, List
+from .output_lut import OutputLUT
+
+
+class PowerZone:
+    """One zone's share of a rail and its latest estimated draw"""
+
+    def __init__(self, name: str, led_count: int, rail: 'PowerRail', amps_per_channel: float,
+                 idle_amps_per_led: float):
+        self.name = name
+        self.led_count = led_count
+        self.rail = rail
+        self.amps_per_channel = amps_per_channel
+        self.idle_amps = idle_amps_per_led * led_count
+        # Draw of the latest frame at full brightness scale, before limiting
+        self.demand_amps = self.idle_amps
+        self._duty = None
+
+    @property
+    def amps(self) -> float:
+        """Estimated draw after limiting"""
+        return self.idle_amps + (self.demand_amps - self.idle_amps) * self.rail.scale
+
+    def estimate(self, pixels, output: OutputLUT, fresh: bool):
+        """
+        Account the frame about to be sent (on the zone's SPI thread)
+
+        Only new frames and brightness changes are measured; a repeated
+        frame keeps its estimate. duty is read once, so the estimate matches
+        one brightness even while another thread changes it.
+        """
+        duty = output.duty
+        if fresh or duty is not self._duty:
+            self._duty = duty
+            self.demand_amps = self.idle_amps + output.output_sum(pixels, duty) * self.amps_per_channel
+
+
+class PowerRail:
+    """
+    A supply shared by some zones, with the brightness scale that keeps it in budget
+
+    update() runs on one SPI thread only, owner's (the first chain given one
+    of the rail's zones), once per frame; other chains read scale. It reads
+    the zones' latest estimates, so zones on other chains count with their
+    last frame.
+    """
+
+    def __init__(self, name: str, budget_amps: float, release_seconds: float):
+        self.name = name
+        self.budget_amps = budget_amps
+        self.release_seconds = release_seconds
+        self.zones: List[PowerZone] = []
+        self.scale = 1.0
+        self.frames_limited = 0
+        self.owner = None
+        self._updated_at = time.monotonic()
+
+    @property
+    def demand_amps(self) -> float:
+        return sum(zone.demand_amps for zone in self.zones)
+
+    @property
+    def amps(self) -> float:
+        return sum(zone.amps for zone in self.zones)
+
+    def update(self) -> float:
+        """Scale for the frame about to be sent: cut at once when over budget, recover over release_seconds"""
+        now = time.monotonic()
+        idle = sum(zone.idle_amps for zone in self.zones)
+        variable = self.demand_amps - idle
+        target = 1.0
+        if variable > 0 and idle + variable > self.budget_amps:
+            target = max(0.0, (self.budget_amps - idle) / variable)
+
+        if target < self.scale:
+            self.scale = target
+        elif self.scale < 1.0:
+            self.scale = min(target, self.scale + (now - self._updated_at) / self.release_seconds)
+        if self.scale < 1.0:
+            self.frames_limited += 1
+        self._updated_at = now
+        return self.scale
+
+
+class PowerLimiter:
+    """Rails from the power config section, and a PowerZone per zone"""
+
+    def __init__(self, config: Dict[str, Any]):
+        for key in ('amps_per_channel', 'idle_amps_per_led', 'release_s', 'rails'):
+            if key not in config:
+                raise ValueError(f"Config missing 'power.{key}'")
+        if config['amps_per_channel'] <= 0:
+            raise ValueError(f"power.amps_per_channel must be positive, got {config['amps_per_channel']}")
+        if config['release_s'] <= 0:
+            raise ValueError(f"power.release_s must be positive, got {config['release_s']}")
+        if not config['rails']:
+            raise ValueError("power.rails must list at least one rail")
+
+        self.amps_per_channel = config['amps_per_channel']
+        self.idle_amps_per_led = config['idle_amps_per_led']
+        self.rails: Dict[str, PowerRail] = {}
+        for name, budget in config['rails'].items():
+            if budget <= 0:
+                raise ValueError(f"power.rails.{name} budget must be positive, got {budget}")
+            self.rails[name] = PowerRail(name, budget, config['release_s'])
+        self.zones: Dict[str, PowerZone] = {}
+
+    def add_zone(self, name: str, led_count: int, rail: str = None) -> PowerZone:
+        """PowerZone for a zone on rail (the first rail when None)"""
+        if rail is None:
+            rail = next(iter(self.rails))
+        if rail not in self.rails:
+            raise ValueError(f"Zone {name} power_rail '{rail}' is not in power.rails {list(self.rails)}")
+        zone = PowerZone(name, led_count, self.rails[rail], self.amps_per_channel, self.idle_amps_per_led)
+        self.rails[rail].zones.append(zone)
+        self.zones[name] = zone
+        return zone
+
+    def stats(self) -> Dict[str, Any]:
+        return {
+            rail.name: {
+                'budget_amps': rail.budget_amps,
+                'demand_amps': rail.demand_amps,
+                'amps': rail.amps,
+                'scale': rail.scale,
+                'frames_limited': rail.frames_limited
+            }
+            for rail in self.rails.values()
+        }
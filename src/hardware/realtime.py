@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+Realtime - CPU pinning, scheduling policy and memory locking for worker threads
+Profiles come from performance.threads in led_config.yaml and are applied by
+each thread to itself when it starts
+"""
+
+import ctypes
+import logging
+import os
+import time
+from typing import Dict, Any
+
+logger = logging.getLogger(__name__)
+
+POLICIES = {
+    'other': os.SCHED_OTHER,
+    'fifo': os.SCHED_FIFO,
+    'rr': os.SCHED_RR,
+}
+
+# linux/mman.h
+MCL_CURRENT = 1
+MCL_FUTURE = 2
+
+_libc = ctypes.CDLL(None, use_errno=True)
+_libc.mlockall.argtypes = [ctypes.c_int]
+_libc.mlockall.restype = ctypes.c_int
+
+
+class ThreadProfile:
+    """CPU set and scheduling policy for one class of thread"""
+
+    def __init__(self, name: str, config: Dict[str, Any]):
+        for key in ('cpus', 'policy', 'priority'):
+            if key not in config:
+                raise ValueError(f"Config missing 'performance.threads.{name}.{key}'")
+
+        cpus = config['cpus']
+        cpu_count = os.cpu_count()
+        if not cpus or any(not isinstance(cpu, int) or not 0 <= cpu < cpu_count for cpu in cpus):
+            raise ValueError(f"performance.threads.{name}.cpus must list CPUs 0-{cpu_count - 1}, got {cpus}")
+
+        policy = config['policy']
+        if policy not in POLICIES:
+            raise ValueError(f"performance.threads.{name}.policy must be one of {sorted(POLICIES)}, got '{policy}'")
+
+        priority = config['priority']
+        low = os.sched_get_priority_min(POLICIES[policy])
+        high = os.sched_get_priority_max(POLICIES[policy])
+        if not low <= priority <= high:
+            raise ValueError(f"performance.threads.{name}.priority must be {low}-{high} for {policy}, got {priority}")
+
+        self.name = name
+        self.cpus = set(cpus)
+        self.policy = policy
+        self.priority = priority
+
+    def apply(self):
+        """
+        Pin and schedule the calling thread
+
+        Failures (usually not running as root) are logged and the thread
+        keeps running under the default scheduler.
+        """
+        try:
+            os.sched_setaffinity(0, self.cpus)
+            os.sched_setscheduler(0, POLICIES[self.policy], os.sched_param(self.priority))
+        except OSError as e:
+            logger.warning(f"Could not apply {self.name} thread profile "
+                           f"(cpus={sorted(self.cpus)}, {self.policy}/{self.priority}): {e}")
+            return
+        logger.info(f"{self.name} thread {os.gettid()} on cpus {sorted(self.cpus)}, "
+                    f"{self.policy} priority {self.priority}")
+
+
+def load_thread_profiles(performance_config: Dict[str, Any]) -> Dict[str, ThreadProfile]:
+    """Parse performance.threads into spi, pattern and audio profiles"""
+    if 'threads' not in performance_config:
+        raise ValueError("Config missing 'performance.threads'")
+    threads_config = performance_config['threads']
+
+    profiles = {}
+    for name in ('spi', 'pattern', 'audio'):
+        if name not in threads_config:
+            raise ValueError(f"Config missing 'performance.threads.{name}'")
+        profiles[name] = ThreadProfile(name, threads_config[name])
+    return profiles
+
+
+def lock_memory():
+    """Lock current and future pages into RAM so frame buffers never page-fault"""
+    if _libc.mlockall(MCL_CURRENT | MCL_FUTURE) != 0:
+        err = ctypes.get_errno()
+        logger.warning(f"mlockall failed: {os.strerror(err)} - memory may be paged during transmission")
+        return
+    logger.info("Process memory locked")
+
+
+class LatencyTracker:
+    """
+    How late timed sleeps wake up - the scheduling latency a thread sees
+
+    Keeps a running mean (exponential once past 1000 samples) and the worst
+    case over the current and previous window, so the max reflects recent
+    behavior rather than startup.
+    """
+
+    def __init__(self, window_seconds: float = 10.0):
+        self.window_seconds = window_seconds
+        self.samples = 0
+        self.mean_ms = 0.0
+        self._window_start = time.time()
+        self._window_max_ms = 0.0
+        self._previous_max_ms = 0.0
+
+    def sleep_until(self, deadline: float):
+        """Sleep until deadline (time.time() seconds) and record the oversleep"""
+        delay = deadline - time.time()
+        if delay <= 0:
+            return
+        time.sleep(delay)
+        self.record(time.time() - deadline)
+
+    def record(self, late_seconds: float):
+        late_ms = max(0.0, late_seconds * 1000)
+        now = time.time()
+        if now - self._window_start >= self.window_seconds:
+            self._previous_max_ms = self._window_max_ms
+            self._window_max_ms = 0.0
+            self._window_start = now
+
+        self.samples += 1
+        self.mean_ms += (late_ms - self.mean_ms) / min(self.samples, 1000)
+        if late_ms > self._window_max_ms:
+            self._window_max_ms = late_ms
+
+    @property
+    def max_ms(self) -> float:
+        return max(self._window_max_ms, self._previous_max_ms)
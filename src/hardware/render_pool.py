@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""
+Render Pool - Pattern threads shared by every zone (performance.execution: threads)
+A fixed set of threads renders all zones each frame, longest zone first, so
+adding zones adds work to the pool instead of another dedicated thread. Large
+zones running TILEABLE patterns are split into pixel tiles that idle threads
+steal, so one heavy zone is no longer capped at one core.
+"""
+
+import logging
+import threading
+import time
+from collections import deque
+from typing import List, Optional
+from effects.compositor import advance_pattern, apply_params
+from .frame_clock import FrameClock
+from .realtime import LatencyTracker, ThreadProfile
+from .zone import Zone
+
+logger = logging.getLogger(__name__)
+
+# Seconds a zone whose pattern raised sits out before it is rendered again
+ERROR_BACKOFF = 0.1
+
+
+class _TiledFrame:
+    """One zone's frame in flight as tiles; the thread finishing the last tile publishes it"""
+
+    def __init__(self, zone: Zone, tiles: int, started: float):
+        self.zone = zone
+        self.remaining = tiles
+        self.started = started
+        self.error: Optional[Exception] = None
+
+
+class RenderPool:
+    """
+    Renders every zone's frame on a shared frame clock with a pool of threads
+
+    Each frame the threads meet at a barrier. The last to arrive waits for
+    the frame's deadline, then orders the zones by smoothed render cost,
+    most expensive first. Every thread then claims zones one at a time
+    (longest-processing-time-first scheduling). All zones render the same
+    frame timestamp.
+
+    A claimed zone whose pattern is TILEABLE and spans at least two tiles
+    of tile_leds LEDs has its serial per-frame work done by the claiming
+    thread (begin_tiles), then its tiles are queued ahead of unclaimed zones.
+    Idle threads wait for tiles while any zone is in flight, and whichever
+    thread finishes a zone's last tile joins it (end_frame) and publishes.
+    Only kernels that release the GIL (compiled kernels, large NumPy
+    operations) render tiles truly in parallel.
+    """
+
+    def __init__(self, zones: List[Zone], thread_count: int, frame_clock: FrameClock,
+                 thread_profile: Optional[ThreadProfile] = None, tile_leds: int = 0):
+        """
+        Args:
+            zones: Zones with a ZoneBuffer, histogram and pattern assigned
+            thread_count: Render threads; capped at the number of zones unless tiling
+            frame_clock: Shared FrameClock frames are paced and timestamped on
+            thread_profile: ThreadProfile each render thread applies to itself
+            tile_leds: Minimum LEDs per tile, or 0 to render every zone whole
+        """
+        if thread_count <= 0:
+            raise ValueError(f"Render pool needs at least one thread, got {thread_count}")
+        if tile_leds < 0:
+            raise ValueError(f"Tile size must be non-negative, got {tile_leds}")
+
+        self.zones = zones
+        self.tile_leds = tile_leds
+        self.thread_count = thread_count if tile_leds else min(thread_count, len(zones))
+        self.frame_clock = frame_clock
+        self.thread_profile = thread_profile
+
+        self.running = False
+        self.threads: List[threading.Thread] = []
+        self._barrier = None
+
+        # Frame being rendered, set by the barrier action
+        self._frame = 0
+        self._skipped = 0
+        self._paced = False
+        self._order: List[Zone] = list(zones)
+        self._next = 0
+
+        # Queued (tiled frame, start, stop) and zones claimed but not yet published
+        self._work = threading.Condition()
+        self._tiles = deque()
+        self._in_flight = 0
+
+        # Oversleep of the frame pacing
+        self.latency = LatencyTracker()
+        self.tiles_rendered = 0
+
+    def is_alive(self) -> bool:
+        return bool(self.threads) and all(thread.is_alive() for thread in self.threads)
+
+    def start(self):
+        """Start the render threads; the first frame renders immediately"""
+        if self.running:
+            raise RuntimeError("Render pool already running")
+        self.running = True
+        self._paced = False
+        self._frame = self.frame_clock.current_frame()
+        self._tiles.clear()
+        self._in_flight = 0
+        self._barrier = threading.Barrier(self.thread_count, action=self._schedule)
+        self.threads = [
+            threading.Thread(target=self._thread, name=f"render-{index}", daemon=True)
+            for index in range(self.thread_count)
+        ]
+        for thread in self.threads:
+            thread.start()
+
+    def stop(self, timeout: float = 1.0):
+        """Stop the render threads after their current task"""
+        if not self.running:
+            return
+        self.running = False
+        self._barrier.abort()
+        with self._work:
+            self._work.notify_all()
+        for thread in self.threads:
+            if thread.is_alive():
+                thread.join(timeout=timeout)
+        self.threads = []
+
+    def _schedule(self):
+        """Barrier action: wait for the next frame's deadline and order its zones"""
+        if self._paced:
+            self._frame, self._skipped = self.frame_clock.wait_next(self._frame, self.latency)
+        self._paced = True
+        self._order = sorted(self.zones, key=lambda zone: zone.budget.load, reverse=True)
+        self._next = 0
+
+    def _claim(self):
+        """
+        Next task of this frame: a queued tile, else an unclaimed zone
+
+        Returns:
+            (tiled frame, start, stop), a Zone, or None once the frame is done
+        """
+        with self._work:
+            while self.running:
+                if self._tiles:
+                    return self._tiles.popleft()
+                if self._next < len(self._order):
+                    zone = self._order[self._next]
+                    self._next += 1
+                    self._in_flight += 1
+                    return zone
+                if self._in_flight == 0:
+                    return None
+                # Another thread may still queue tiles for a zone it claimed
+                self._work.wait()
+            return None
+
+    def _finished(self):
+        """A claimed zone was published (or abandoned)"""
+        with self._work:
+            self._in_flight -= 1
+            if self._in_flight == 0:
+                self._work.notify_all()
+
+    def _thread(self):
+        """Render thread: take tasks each frame until the pool stops"""
+        logger.debug(f"{threading.current_thread().name} started")
+        if self.thread_profile is not None:
+            self.thread_profile.apply()
+
+        while self.running:
+            try:
+                self._barrier.wait()
+            except threading.BrokenBarrierError:
+                if not self.running:
+                    break
+                logger.error("Render pool barrier broken")
+                self._barrier.reset()
+                continue
+
+            task = self._claim()
+            while task is not None:
+                if isinstance(task, Zone):
+                    self._render(task)
+                else:
+                    self._render_tile(*task)
+                task = self._claim()
+
+        logger.debug(f"{threading.current_thread().name} exited")
+
+    def _tile_count(self, zone: Zone) -> int:
+        if not self.tile_leds or self.thread_count < 2 or not zone.pattern.TILEABLE:
+            return 1
+        return min(zone.led_count // self.tile_leds, self.thread_count)
+
+    def _render(self, zone: Zone):
+        """Render and publish one zone's frame, or queue its tiles"""
+        gen_start = time.time()
+        if gen_start < zone.retry_at:
+            self._finished()
+            return
+        tiled = None
+        try:
+            zone.pattern = advance_pattern(zone.pattern, zone.pending_switch())
+            params = zone.pending_params()
+            if params:
+                unknown = apply_params(zone.pattern, params)
+                if unknown:
+                    logger.warning(f"{zone.name} pattern has no params {unknown}, skipped")
+            tiles = self._tile_count(zone)
+            if tiles > 1:
+                zone.pattern.begin_tiles(zone.buffer.back, self.frame_clock.timestamp(self._frame))
+                tiled = _TiledFrame(zone, tiles, gen_start)
+                bounds = [zone.led_count * index // tiles for index in range(tiles + 1)]
+                with self._work:
+                    # Ahead of unclaimed zones: this one is already on the critical path
+                    self._tiles.extend((tiled, bounds[index], bounds[index + 1]) for index in range(tiles))
+                    self._work.notify_all()
+                return
+            zone.pattern.render(zone.buffer.back, self.frame_clock.timestamp(self._frame))
+        except Exception as e:
+            self._failed(zone, e)
+            self._finished()
+            return
+        self._publish(zone, gen_start)
+        self._finished()
+
+    def _render_tile(self, tiled: _TiledFrame, start: int, stop: int):
+        """Render one tile; the last one to finish joins and publishes the zone"""
+        try:
+            tiled.zone.pattern.render_tile(start, stop)
+        except Exception as e:
+            tiled.error = e
+        with self._work:
+            tiled.remaining -= 1
+            self.tiles_rendered += 1
+            last = tiled.remaining == 0
+        if not last:
+            return
+
+        zone = tiled.zone
+        if tiled.error is not None:
+            self._failed(zone, tiled.error)
+        else:
+            try:
+                zone.pattern.end_frame()
+                self._publish(zone, tiled.started)
+            except Exception as e:
+                self._failed(zone, e)
+        self._finished()
+
+    def _publish(self, zone: Zone, gen_start: float):
+        """Hand a finished frame to the SPI thread and update the zone's budget"""
+        render_seconds = time.time() - gen_start
+        zone.last_generation_ms = render_seconds * 1000
+        zone.histogram.record(zone.last_generation_ms)
+
+        zone.buffer.publish()
+        zone.frames_generated += 1
+        zone.consecutive_errors = 0
+        zone.pattern.set_quality(zone.budget.record(render_seconds, self._skipped))
+
+    def _failed(self, zone: Zone, error: Exception):
+        zone.errors += 1
+        zone.consecutive_errors += 1
+        zone.retry_at = time.time() + ERROR_BACKOFF
+        logger.error(f"{zone.name} pattern error: {error}")
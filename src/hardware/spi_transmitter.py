@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""
+SPI Transmitter - Direct spidev ioctl output of a pinned bitstream buffer
+Sends the frame as prebuilt SPI_IOC_MESSAGE transfers sized to the spidev
+bufsiz, optionally streaming chunks while later zones are still encoding
+"""
+
+import ctypes
+import logging
+import os
+import queue
+import threading
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+SPIDEV_BUFSIZ_PATH = "/sys/module/spidev/parameters/bufsiz"
+
+# Queued by begin_frame() ahead of a frame's encoded() offsets
+FRAME_START = -1
+
+# linux/spi/spidev.h ioctl numbers: _IOW('k', nr, size)
+_IOC_WRITE = 1
+_SPI_IOC_MAGIC = ord('k')
+
+
+def _iow(nr: int, size: int) -> int:
+    return (_IOC_WRITE << 30) | (size << 16) | (_SPI_IOC_MAGIC << 8) | nr
+
+
+class SpiIocTransfer(ctypes.Structure):
+    """struct spi_ioc_transfer from linux/spi/spidev.h"""
+    _fields_ = [
+        ('tx_buf', ctypes.c_uint64),
+        ('rx_buf', ctypes.c_uint64),
+        ('len', ctypes.c_uint32),
+        ('speed_hz', ctypes.c_uint32),
+        ('delay_usecs', ctypes.c_uint16),
+        ('bits_per_word', ctypes.c_uint8),
+        ('cs_change', ctypes.c_uint8),
+        ('tx_nbits', ctypes.c_uint8),
+        ('rx_nbits', ctypes.c_uint8),
+        ('word_delay_usecs', ctypes.c_uint8),
+        ('pad', ctypes.c_uint8),
+    ]
+
+
+SPI_IOC_MESSAGE_1 = _iow(0, ctypes.sizeof(SpiIocTransfer))
+SPI_IOC_WR_MODE = _iow(1, 1)
+SPI_IOC_WR_BITS_PER_WORD = _iow(3, 1)
+SPI_IOC_WR_MAX_SPEED_HZ = _iow(4, 4)
+
+_libc = ctypes.CDLL(None, use_errno=True)
+_libc.ioctl.argtypes = [ctypes.c_int, ctypes.c_ulong, ctypes.c_void_p]
+_libc.ioctl.restype = ctypes.c_int
+_libc.mlock.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+_libc.mlock.restype = ctypes.c_int
+
+
+def read_spidev_bufsiz() -> int:
+    """Read the spidev kernel transfer limit in bytes"""
+    if not os.path.exists(SPIDEV_BUFSIZ_PATH):
+        raise RuntimeError(f"{SPIDEV_BUFSIZ_PATH} not found - is the spidev module loaded?")
+    with open(SPIDEV_BUFSIZ_PATH, 'r') as f:
+        return int(f.read().strip())
+
+
+class SPITransmitter:
+    """Sends a fixed bitstream buffer to a spidev device as back-to-back transfers"""
+
+    def __init__(self, device_path: str, speed_hz: int, buffer: np.ndarray, streaming: bool = False,
+                 thread_profile=None):
+        if buffer.dtype != np.uint8 or buffer.ndim != 1 or not buffer.flags['C_CONTIGUOUS']:
+            raise ValueError("Transmit buffer must be a contiguous 1-D uint8 array")
+
+        self.device_path = device_path
+        self.speed_hz = speed_hz
+        self.buffer = buffer
+        self.total_bytes = buffer.nbytes
+        self.streaming = streaming
+        self.thread_profile = thread_profile
+
+        # spidev rejects any single message larger than bufsiz
+        self.chunk_size = read_spidev_bufsiz()
+        self._transfers = self._build_transfers()
+        if len(self._transfers) > 1:
+            logger.warning(
+                f"Frame of {self.total_bytes} bytes needs {len(self._transfers)} transfers "
+                f"(spidev bufsiz={self.chunk_size}); set spidev.bufsiz={self.total_bytes} "
+                f"or larger in cmdline.txt for a single gapless transfer"
+            )
+
+        if _libc.mlock(buffer.ctypes.data, buffer.nbytes) != 0:
+            err = ctypes.get_errno()
+            raise OSError(err, f"mlock of SPI buffer failed: {os.strerror(err)}")
+
+        self.fd = os.open(device_path, os.O_RDWR)
+        self._configure()
+
+        # Streaming state: encoded byte offsets flow to the send worker. Frames
+        # are numbered by begin_frame(); the worker counts FRAME_START markers
+        # to the same numbers and reports which frame it reached and sent
+        self._encoded_to = queue.SimpleQueue()
+        self._progress = threading.Condition()
+        self._generation = 0
+        self._started = 0
+        self._sent = 0
+        self._stream_error = None
+        self._worker = None
+        if streaming:
+            self._worker = threading.Thread(target=self._stream_worker, daemon=True)
+            self._worker.start()
+
+        logger.info(f"SPI transmitter on {device_path}: {self.total_bytes} bytes in "
+                    f"{len(self._transfers)} transfer(s), streaming={'on' if streaming else 'off'}")
+
+    def _ioctl(self, request: int, arg: int):
+        if _libc.ioctl(self.fd, request, arg) < 0:
+            err = ctypes.get_errno()
+            raise OSError(err, f"SPI ioctl 0x{request:08x} on {self.device_path} failed: {os.strerror(err)}")
+
+    def _configure(self):
+        """Mode 0, 8 bits per word, fixed clock"""
+        mode = ctypes.c_uint8(0)
+        bits = ctypes.c_uint8(8)
+        speed = ctypes.c_uint32(self.speed_hz)
+        self._ioctl(SPI_IOC_WR_MODE, ctypes.addressof(mode))
+        self._ioctl(SPI_IOC_WR_BITS_PER_WORD, ctypes.addressof(bits))
+        self._ioctl(SPI_IOC_WR_MAX_SPEED_HZ, ctypes.addressof(speed))
+
+    def _build_transfers(self) -> list:
+        """Prebuild one transfer descriptor per bufsiz-sized chunk of the buffer"""
+        base = self.buffer.ctypes.data
+        transfers = []
+        for offset in range(0, self.total_bytes, self.chunk_size):
+            transfer = SpiIocTransfer()
+            transfer.tx_buf = base + offset
+            transfer.len = min(self.chunk_size, self.total_bytes - offset)
+            transfer.speed_hz = self.speed_hz
+            transfer.bits_per_word = 8
+            transfers.append((offset + transfer.len, ctypes.addressof(transfer), transfer))
+        return transfers
+
+    def send(self):
+        """Send the whole buffer, blocking until the last transfer completes"""
+        for _, address, _ in self._transfers:
+            self._ioctl(SPI_IOC_MESSAGE_1, address)
+
+    def begin_frame(self, timeout: float = 1.0):
+        """
+        Start a streamed frame; chunks go out as encoded() reports progress
+
+        Returns once the worker has reached this frame, so no chunk of an
+        earlier one (abandoned, or timed out in finish_frame) is still on the
+        wire when the caller starts encoding over the buffer.
+        """
+        if not self.streaming:
+            raise RuntimeError("begin_frame() requires streaming mode")
+        self._generation += 1
+        generation = self._generation
+        # Restarts the chunk cursor even if the last frame was abandoned mid-encode
+        self._encoded_to.put(FRAME_START)
+        with self._progress:
+            if not self._progress.wait_for(lambda: self._started == generation, timeout):
+                raise RuntimeError(f"Previous frame on {self.device_path} still sending after {timeout}s")
+
+    def encoded(self, end_byte: int):
+        """Report that buffer[0:end_byte] is encoded; reaching total_bytes completes the frame"""
+        self._encoded_to.put(end_byte)
+
+    def finish_frame(self, timeout: float = 1.0):
+        """Wait until the frame from the last begin_frame() has been fully sent"""
+        generation = self._generation
+        with self._progress:
+            sent = self._progress.wait_for(lambda: self._sent == generation, timeout)
+        if not sent:
+            raise RuntimeError(f"Streamed frame on {self.device_path} not sent within {timeout}s")
+        if self._stream_error:
+            error, self._stream_error = self._stream_error, None
+            raise error
+
+    def _stream_worker(self):
+        """Send each chunk as soon as every byte in it has been encoded"""
+        if self.thread_profile is not None:
+            self.thread_profile.apply()
+        next_chunk = 0
+        generation = 0
+        while True:
+            end_byte = self._encoded_to.get()
+            if end_byte is None:
+                break
+            if end_byte == FRAME_START:
+                # Anything left of an abandoned frame (and its error) is dropped
+                next_chunk = 0
+                self._stream_error = None
+                generation += 1
+                with self._progress:
+                    self._started = generation
+                    self._progress.notify_all()
+                continue
+
+            while next_chunk < len(self._transfers) and self._transfers[next_chunk][0] <= end_byte:
+                try:
+                    self._ioctl(SPI_IOC_MESSAGE_1, self._transfers[next_chunk][1])
+                except OSError as e:
+                    self._stream_error = e
+                    next_chunk = len(self._transfers)
+                    break
+                next_chunk += 1
+
+            if end_byte >= self.total_bytes:
+                with self._progress:
+                    self._sent = generation
+                    self._progress.notify_all()
+
+    def close(self):
+        """Stop the stream worker and close the device"""
+        if self._worker and self._worker.is_alive():
+            self._encoded_to.put(None)
+            self._worker.join(timeout=1.0)
+        os.close(self.fd)
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Virtual SPI - Stand-in transmitter that records frames and simulates wire time
+Selected with hardware.spi_backend: virtual, so the full pipeline runs on a
+development machine or in benchmarks without spidev or root
+"""
+
+import logging
+import time
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+
+class VirtualSPITransmitter:
+    """Same interface as SPITransmitter; sleeps for the frame's bit time instead of sending"""
+
+    def __init__(self, device_path: str, speed_hz: int, buffer: np.ndarray, streaming: bool = False,
+                 thread_profile=None):
+        if buffer.dtype != np.uint8 or buffer.ndim != 1 or not buffer.flags['C_CONTIGUOUS']:
+            raise ValueError("Transmit buffer must be a contiguous 1-D uint8 array")
+
+        self.device_path = device_path
+        self.speed_hz = speed_hz
+        self.buffer = buffer
+        self.total_bytes = buffer.nbytes
+        self.streaming = streaming
+        self.wire_seconds = self.total_bytes * 8 / speed_hz
+
+        # Recorded output
+        self.last_frame = np.zeros_like(buffer)
+        self.frames_sent = 0
+        self.bytes_sent = 0
+
+        self._wire_start = None
+
+        logger.info(f"Virtual SPI on {device_path}: {self.total_bytes} bytes, "
+                    f"{self.wire_seconds * 1000:.2f}ms simulated wire time")
+
+    def _record(self):
+        np.copyto(self.last_frame, self.buffer)
+        self.frames_sent += 1
+        self.bytes_sent += self.total_bytes
+
+    def send(self):
+        """Record the buffer and block for its wire time"""
+        start = time.perf_counter()
+        self._record()
+        remaining = self.wire_seconds - (time.perf_counter() - start)
+        if remaining > 0:
+            time.sleep(remaining)
+
+    def begin_frame(self, timeout: float = 1.0):
+        if not self.streaming:
+            raise RuntimeError("begin_frame() requires streaming mode")
+        self._wire_start = None
+
+    def encoded(self, end_byte: int):
+        # Streaming puts the first chunk on the wire as soon as it is encoded
+        if self._wire_start is None:
+            self._wire_start = time.perf_counter()
+
+    def finish_frame(self, timeout: float = 1.0):
+        """Block until the wire time counted from the first encoded chunk has passed"""
+        if self._wire_start is None:
+            raise RuntimeError(f"Streamed frame on {self.device_path} finished before any chunk was encoded")
+        self._record()
+        remaining = self.wire_seconds - (time.perf_counter() - self._wire_start)
+        if remaining > 0:
+            time.sleep(remaining)
+
+    def close(self):
+        pass
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+WS2811 Encoder - Lookup-table SPI bitstream encoder
+Converts (N, 3) uint8 RGB frames to the 8x oversampled SPI bitstream in one pass
+"""
+
+import numpy as np
+from typing import Optional
+
+# One WS2811 data bit is sent as one SPI byte at 8x the WS2811 data rate
+BIT_LOW = 0xC0   # 11000000 - short high pulse
+BIT_HIGH = 0xF8  # 11111000 - long high pulse
+BYTES_PER_CHANNEL = 8
+CHANNELS = 3
+BYTES_PER_LED = CHANNELS * BYTES_PER_CHANNEL
+
+
+def build_bitstream_table() -> np.ndarray:
+    """
+    Build the 256-entry byte -> 8-byte bitstream table
+
+    Returns:
+        uint64 array of shape (256,), each entry holding the 8 SPI bytes
+        for one channel value in memory order (MSB first on the wire)
+    """
+    values = np.arange(256, dtype=np.uint8)
+    bits = np.unpackbits(values[:, np.newaxis], axis=1)
+    table = np.where(bits == 1, BIT_HIGH, BIT_LOW).astype(np.uint8)
+    return np.ascontiguousarray(table).view(np.uint64).reshape(256)
+
+
+def parse_color_order(color_order: str) -> tuple:
+    """
+    Convert a color order string like 'GRB' to RGB channel indices in wire order
+
+    Raises:
+        ValueError: If the string is not a permutation of 'RGB'
+    """
+    order = color_order.upper()
+    if sorted(order) != ['B', 'G', 'R']:
+        raise ValueError(f"Invalid color order '{color_order}', must be a permutation of 'RGB'")
+    return tuple('RGB'.index(channel) for channel in order)
+
+
+class WS2811Encoder:
+    """Encodes RGB frames into a preallocated SPI bitstream buffer"""
+
+    TABLE = build_bitstream_table()
+
+    def __init__(self, led_count: int, color_order: str = "GRB"):
+        if led_count <= 0:
+            raise ValueError(f"LED count must be positive, got {led_count}")
+
+        self.led_count = led_count
+        self.color_order = color_order.upper()
+        self.channel_order = parse_color_order(color_order)
+
+        # Buffer handed to spidev, viewed as one uint64 word per channel
+        self.buffer = np.zeros(led_count * BYTES_PER_LED, dtype=np.uint8)
+        self._words = self.buffer.view(np.uint64).reshape(led_count, CHANNELS)
+        self.clear()
+
+    def encode(self, pixels: np.ndarray, start: int = 0,
+               tables: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        Encode RGB pixels into the bitstream buffer
+
+        Args:
+            pixels: uint8 array of shape (count, 3) in RGB order
+            start: LED index in the chain where these pixels begin
+            tables: Optional (3, 256) uint64 per-channel bitstream tables in RGB
+                    order, e.g. with gamma and brightness folded in
+
+        Returns:
+            The full bitstream buffer
+        """
+        count = pixels.shape[0]
+        if pixels.dtype != np.uint8 or pixels.ndim != 2 or pixels.shape[1] != CHANNELS:
+            raise ValueError(f"Pixels must be uint8 of shape (N, 3), got {pixels.dtype} {pixels.shape}")
+        if start < 0 or start + count > self.led_count:
+            raise ValueError(f"Pixels {start}-{start + count} exceed chain of {self.led_count} LEDs")
+
+        words = self._words[start:start + count]
+        for wire_slot, channel in enumerate(self.channel_order):
+            table = self.TABLE if tables is None else tables[channel]
+            np.take(table, pixels[:, channel], out=words[:, wire_slot], mode='clip')
+
+        return self.buffer
+
+    def clear(self):
+        """Encode all LEDs as off"""
+        self._words.fill(self.TABLE[0])
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+Zone - One strip from led_config.yaml and the state of the pattern rendering it
+Zones are built from the strips list in wire order, so adding a strip adds a
+zone without new threads, buffers or setters in the controller
+"""
+
+import queue
+from pathlib import Path
+from typing import Any, Dict, List, Optional
+from .frame_clock import RenderBudget
+from .realtime import LatencyTracker
+from effects.geometry import Geometry
+
+
+def zone_name(strip: Dict[str, Any]) -> str:
+    """Name a strips entry is addressed by: its name, or its id when unnamed"""
+    return strip['name'] if 'name' in strip else strip['id']
+
+
+class Zone:
+    """
+    A strip's pattern, frame handoff, output correction and render counters
+
+    The controller fills in buffer (a ZoneBuffer, or a ZoneWorker in process
+    execution), output, interpolator (when interpolate is set), power (with
+    power limiting on) and histogram. While running, only the render thread
+    or worker owning the zone reassigns pattern and the counters.
+    """
+
+    def __init__(self, name: str, strip_id: str, led_count: int, device: str,
+                 chain_offset: Optional[int], geometry: Geometry, frame_budget: float,
+                 interpolate: bool = False, power_rail: Optional[str] = None):
+        """
+        Args:
+            name: Zone name used by the API, startup config and metrics
+            strip_id: id of the strips entry
+            led_count: LEDs in the strip
+            device: SPI device of the strip's chain
+            chain_offset: LEDs on the chain before this strip, or None to
+                          follow the previous strip on the same device
+            geometry: Physical layout shared by the zone's patterns
+            frame_budget: Render seconds per frame before target_fps is at risk
+            interpolate: Blend between rendered frames at the transmit rate
+            power_rail: Supply rail in power.rails, or None for the first
+        """
+        self.name = name
+        self.strip_id = strip_id
+        self.led_count = led_count
+        self.device = device
+        self.chain_offset = chain_offset
+        self.geometry = geometry
+        self.interpolate = interpolate
+        self.power_rail = power_rail
+
+        self.buffer = None
+        self.output = None
+        self.interpolator = None
+        self.power = None
+        self.histogram = None
+
+        # Pattern, and live switches queued by LEDController.switch_pattern()
+        self.pattern = None
+        self.switches = queue.SimpleQueue()
+        # Param updates queued by LEDController.set_params(), applied between frames
+        self.param_updates = queue.SimpleQueue()
+
+        # Adaptive render quality against the target_fps budget
+        self.budget = RenderBudget(frame_budget)
+        # Oversleep of the worker process's frame pacing (process execution)
+        self.latency = LatencyTracker()
+
+        # Consecutive errors reset on each success
+        self.frames_generated = 0
+        self.errors = 0
+        self.consecutive_errors = 0
+        self.last_generation_ms = 0.0
+        # time.time() before which a failing pattern is not retried
+        self.retry_at = 0.0
+
+    @classmethod
+    def from_config(cls, strip: Dict[str, Any], default_device: str, config_dir: Path,
+                    frame_budget: float) -> 'Zone':
+        """
+        Build a zone from a strips entry
+
+        Args:
+            strip: Entry with id and led_count, and optionally name,
+                   spi_device, chain_offset, interpolate, power_rail and layout
+            default_device: hardware.spi_device, for strips without their own
+            config_dir: Directory layout points files are resolved against
+            frame_budget: Render seconds per frame (FrameClock.budget)
+        """
+        for key in ('id', 'led_count'):
+            if key not in strip:
+                raise ValueError(f"Config missing 'strips[].{key}' in {strip}")
+        led_count = strip['led_count']
+        if not isinstance(led_count, int) or led_count <= 0:
+            raise ValueError(f"strips.{strip['id']}.led_count must be a positive integer, got {led_count}")
+
+        chain_offset = strip['chain_offset'] if 'chain_offset' in strip else None
+        if chain_offset is not None and (not isinstance(chain_offset, int) or chain_offset < 0):
+            raise ValueError(f"strips.{strip['id']}.chain_offset must be a non-negative integer, got {chain_offset}")
+
+        interpolate = strip['interpolate'] if 'interpolate' in strip else False
+        if not isinstance(interpolate, bool):
+            raise ValueError(f"strips.{strip['id']}.interpolate must be true or false, got {interpolate}")
+
+        return cls(zone_name(strip), strip['id'], led_count,
+                   strip['spi_device'] if 'spi_device' in strip else default_device,
+                   chain_offset, Geometry.from_config(strip, config_dir), frame_budget, interpolate,
+                   strip['power_rail'] if 'power_rail' in strip else None)
+
+    def pending_switch(self):
+        """Next queued (pattern, crossfade) switch, or None"""
+        try:
+            return self.switches.get_nowait()
+        except queue.Empty:
+            return None
+
+    def pending_params(self):
+        """Every queued param update merged (latest value wins), or None"""
+        if self.param_updates.empty():
+            return None
+        merged = {}
+        while not self.param_updates.empty():
+            merged.update(self.param_updates.get_nowait())
+        return merged
+
+    def worker_report(self, sequence: int, render_ms: float, late: float, quality: float, errors: int,
+                      consecutive_errors: int):
+        """Worker process announcement (ZoneWorker report), read on the SPI thread"""
+        self.frames_generated = sequence
+        self.budget.quality = quality
+        self.errors = errors
+        self.consecutive_errors = consecutive_errors
+        if render_ms >= 0:
+            self.last_generation_ms = render_ms
+            self.histogram.record(render_ms)
+        if late >= 0:
+            self.latency.record(late)
+
+
+def zones_from_config(strips: List[Dict[str, Any]], default_device: str, config_dir: Path,
+                      frame_budget: float) -> List[Zone]:
+    """Zones for every strips entry, in list (wire) order, with unique ids and names"""
+    if not strips:
+        raise ValueError("Config 'strips' must list at least one strip")
+
+    zones = []
+    ids = set()
+    names = set()
+    for strip in strips:
+        zone = Zone.from_config(strip, default_device, config_dir, frame_budget)
+        if zone.strip_id in ids:
+            raise ValueError(f"Duplicate strip id '{zone.strip_id}'")
+        if zone.name in names:
+            raise ValueError(f"Duplicate zone name '{zone.name}'")
+        ids.add(zone.strip_id)
+        names.add(zone.name)
+        zones.append(zone)
+    return zones
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""
+Zone Process - Pattern rendering in a worker process, outside the controller's GIL
+Selected with performance.execution: processes. Each zone's pattern renders into
+a three-slot shared-memory segment and announces every finished frame by
+sequence number over a pipe; the SPI thread copies the newest one out.
+"""
+
+import logging
+import multiprocessing
+import os
+import queue
+import signal
+import struct
+import time
+import numpy as np
+from multiprocessing import shared_memory
+from typing import Callable, Optional, Tuple
+from effects.compositor import advance_pattern, apply_params
+from .frame_clock import FrameClock, RenderBudget
+
+logger = logging.getLogger(__name__)
+
+# Worker -> controller, one per frame or error:
+# sequence, published_at (0 for error reports), render_ms, oversleep of the
+# previous pacing sleep (s, negative if none), quality, errors, consecutive errors
+MESSAGE = struct.Struct('<qddddqq')
+SLOTS = 3
+
+# fork hands the running pattern object to the child without pickling it
+_context = multiprocessing.get_context('fork')
+
+
+class _LastLate:
+    """Latency sink for FrameClock.wait_next that keeps only the latest oversleep"""
+
+    def __init__(self):
+        self.value = -1.0
+
+    def record(self, late_seconds: float):
+        self.value = late_seconds
+
+
+def _worker_main(name: str, pattern, frames: np.ndarray, write_fd: int, read_fd: int,
+                 stop_event, switches, frame_clock: FrameClock, thread_profile, parent_pid: int):
+    """Worker process: render, publish by sequence number, pace on the shared frame clock"""
+    # Ctrl+C goes to the whole process group; the controller stops us via stop_event
+    signal.signal(signal.SIGINT, signal.SIG_IGN)
+    os.close(read_fd)
+    if thread_profile is not None:
+        thread_profile.apply()
+
+    sequence = 0
+    errors = 0
+    consecutive_errors = 0
+    budget = RenderBudget(frame_clock.budget)
+    late = _LastLate()
+    frame = frame_clock.current_frame()
+
+    while not stop_event.is_set() and os.getppid() == parent_pid:
+        try:
+            # Switches arrive as (pattern, crossfade), param updates as dicts
+            while True:
+                try:
+                    message = switches.get_nowait()
+                except queue.Empty:
+                    break
+                if isinstance(message, dict):
+                    unknown = apply_params(pattern, message)
+                    if unknown:
+                        logger.warning(f"{name} pattern has no params {unknown}, skipped")
+                    continue
+                logger.info(f"{name} worker switching to {message[0].__class__.__name__} ({message[1]}s crossfade)")
+                pattern = advance_pattern(pattern, message)
+            pattern = advance_pattern(pattern)
+
+            gen_start = time.time()
+            pattern.render(frames[(sequence + 1) % SLOTS], frame_clock.timestamp(frame))
+            render_seconds = time.time() - gen_start
+
+            sequence += 1
+            consecutive_errors = 0
+            os.write(write_fd, MESSAGE.pack(sequence, time.time(), render_seconds * 1000, late.value,
+                                            budget.quality, errors, 0))
+            late.value = -1.0
+
+            frame, skipped = frame_clock.wait_next(frame, late)
+            pattern.set_quality(budget.record(render_seconds, skipped))
+
+        except Exception as e:
+            errors += 1
+            consecutive_errors += 1
+            logger.error(f"{name} pattern error: {e}")
+            try:
+                os.write(write_fd, MESSAGE.pack(sequence, 0.0, -1.0, -1.0, budget.quality, errors, consecutive_errors))
+            except OSError:
+                break
+            time.sleep(0.1)
+            frame = frame_clock.current_frame()
+
+    os.close(write_fd)
+
+
+class ZoneWorker:
+    """
+    One zone's pattern process, and the controller-side reader of its frames
+
+    Stands in for a ZoneBuffer in an OutputChain: acquire() returns the
+    freshest complete frame and whether it is new. Slot (sequence % 3) holds
+    frame `sequence`, so the worker only reuses the slot being copied after
+    publishing two newer frames; seeing sequence + 2 announced after the
+    copy means it may be torn, and the copy is retried with the newer frame.
+    The pipe's syscalls order the shared-memory writes against the reads.
+    """
+
+    def __init__(self, name: str, count: int, frame_clock: FrameClock, thread_profile,
+                 report: Callable[[int, float, float, float, int, int], None]):
+        """
+        Args:
+            name: Zone name for logs and the process title
+            count: LEDs in the zone
+            frame_clock: Shared FrameClock the worker paces and timestamps frames on
+            thread_profile: ThreadProfile the worker applies to itself
+            report: Called from acquire() with (sequence, render_ms or -1,
+                    oversleep seconds or -1, quality, errors, consecutive errors)
+        """
+        self.name = name
+        self.count = count
+        self.frame_clock = frame_clock
+        self.thread_profile = thread_profile
+        self.report = report
+
+        self.shared = shared_memory.SharedMemory(create=True, size=SLOTS * count * 3)
+        self.frames = np.ndarray((SLOTS, count, 3), dtype=np.uint8, buffer=self.shared.buf)
+        self.frames.fill(0)
+        self._front = np.zeros((count, 3), dtype=np.uint8)
+
+        self.process: Optional[multiprocessing.Process] = None
+        self._stop_event = None
+        self._switches = None
+        self._read_fd = None
+
+        self._announced = 0                     # Newest sequence seen on the pipe
+        self._front_sequence = 0                # Sequence held in _front
+        self._published_at = [0.0] * SLOTS      # Per slot, from the worker's announcement
+        self._front_published_at = 0.0
+
+        self.frames_published = 0
+        self.frames_dropped = 0
+        self.frames_repeated = 0
+
+    @property
+    def front_published_at(self) -> float:
+        """When the frame last returned by acquire() was published"""
+        return self._front_published_at
+
+    def is_alive(self) -> bool:
+        return self.process is not None and self.process.is_alive()
+
+    def start_worker(self, pattern):
+        """Fork the worker process running pattern"""
+        if self.is_alive():
+            raise RuntimeError(f"{self.name} worker already running")
+
+        read_fd, write_fd = os.pipe()
+        os.set_blocking(read_fd, False)
+        self._read_fd = read_fd
+        self._stop_event = _context.Event()
+        self._switches = _context.Queue()
+        self._announced = 0
+        self._front_sequence = 0
+
+        self.process = _context.Process(
+            target=_worker_main,
+            args=(self.name, pattern, self.frames, write_fd, read_fd, self._stop_event,
+                  self._switches, self.frame_clock, self.thread_profile, os.getpid()),
+            name=f"{self.name}-pattern",
+            daemon=True
+        )
+        self.process.start()
+        os.close(write_fd)
+        logger.info(f"{self.name} pattern worker started (pid {self.process.pid})")
+
+    def stop_worker(self, timeout: float = 1.0):
+        """Ask the worker to exit, and terminate it if it does not"""
+        if self.process is None:
+            return
+        self._stop_event.set()
+        self.process.join(timeout=timeout)
+        if self.process.is_alive():
+            logger.warning(f"{self.name} pattern worker did not exit, terminating")
+            self.process.terminate()
+            self.process.join(timeout=timeout)
+        self.process = None
+        os.close(self._read_fd)
+        self._read_fd = None
+        # Never wait on a switch still buffered for a worker that is gone
+        self._switches.cancel_join_thread()
+        self._switches.close()
+        self._switches = None
+
+    def switch(self, pattern, crossfade: float):
+        """
+        Send a new pattern to the running worker, which crossfades to it
+
+        The pattern is pickled to the worker, so it must not hold unpicklable
+        state such as a bound audio analyzer.
+        """
+        if not self.is_alive():
+            raise RuntimeError(f"{self.name} worker is not running")
+        self._switches.put((pattern, crossfade))
+
+    def set_params(self, params):
+        """Send param updates to the running worker, applied before its next frame"""
+        if not self.is_alive():
+            raise RuntimeError(f"{self.name} worker is not running")
+        self._switches.put(dict(params))
+
+    def close(self):
+        """Stop the worker and release the shared segment"""
+        self.stop_worker()
+        self.frames = None
+        self.shared.close()
+        self.shared.unlink()
+
+    def _drain(self) -> int:
+        """Read every pending announcement and return the newest sequence"""
+        if self._read_fd is None:
+            return self._announced
+        while True:
+            try:
+                data = os.read(self._read_fd, MESSAGE.size * 64)
+            except BlockingIOError:
+                break
+            if not data:
+                break
+            for sequence, published_at, render_ms, late, quality, errors, consecutive in MESSAGE.iter_unpack(data):
+                if published_at > 0:
+                    self._published_at[sequence % SLOTS] = published_at
+                    self._announced = sequence
+                self.report(sequence, render_ms, late, quality, errors, consecutive)
+        return self._announced
+
+    def acquire(self) -> Tuple[np.ndarray, bool]:
+        """
+        Reader: copy out the freshest complete frame without blocking
+
+        Returns:
+            Tuple of (pixels, True if the frame is new since last acquire)
+        """
+        latest = self._drain()
+        if latest <= self._front_sequence:
+            self.frames_repeated += 1
+            return self._front, False
+
+        for _ in range(SLOTS):
+            np.copyto(self._front, self.frames[latest % SLOTS])
+            newest = self._drain()
+            if newest < latest + 2:
+                break
+            latest = newest
+
+        self.frames_published = latest
+        self.frames_dropped += latest - self._front_sequence - 1
+        self._front_sequence = latest
+        self._front_published_at = self._published_at[latest % SLOTS]
+        return self._front, True
@@ -0,0 +1,14 @@
+#!/usr/bin/env python3
+"""
+Monitoring Module - Latency histograms and the metrics endpoint
+"""
+
+from .histogram import LatencyHistogram
+from .registry import MetricsRegistry
+from .server import MetricsServer
+
+__all__ = [
+    'LatencyHistogram',
+    'MetricsRegistry',
+    'MetricsServer'
+]
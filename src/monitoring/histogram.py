@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Latency Histogram - Fixed-bucket timing histograms over a rolling window
+Recording is a bucket lookup and two array increments, with no per-sample
+storage, so it is safe to call from the SPI and audio hot paths
+"""
+
+import time
+from bisect import bisect_left
+from typing import Dict
+import numpy as np
+
+# Bucket upper bounds in ms: 4 per octave from 10us to ~1.1s (under 19% error),
+# plus one overflow bucket above the last bound
+BUCKET_BOUNDS_MS = tuple(0.01 * 2 ** (i / 4) for i in range(68))
+BUCKET_COUNT = len(BUCKET_BOUNDS_MS) + 1
+
+# Rolling window resolution
+WINDOW_SLOTS = 30
+
+
+class LatencyHistogram:
+    """
+    Millisecond histogram of one pipeline stage
+
+    Counts go into one of WINDOW_SLOTS time slots, and snapshots sum the
+    slots still inside the window. Lifetime bucket counts are kept alongside
+    for cumulative (Prometheus) export. One thread records; any thread reads.
+    """
+
+    def __init__(self, name: str, labels: Dict[str, str], window_seconds: float):
+        if window_seconds <= 0:
+            raise ValueError(f"Histogram window must be positive, got {window_seconds}")
+
+        self.name = name
+        self.labels = labels
+        self.window_seconds = window_seconds
+        self.slot_seconds = window_seconds / WINDOW_SLOTS
+
+        self._counts = np.zeros((WINDOW_SLOTS, BUCKET_COUNT), dtype=np.int64)
+        self._max_ms = np.zeros(WINDOW_SLOTS, dtype=np.float64)
+        self._epochs = [-WINDOW_SLOTS] * WINDOW_SLOTS
+
+        self.lifetime_counts = np.zeros(BUCKET_COUNT, dtype=np.int64)
+        self.lifetime_sum_ms = 0.0
+        self.lifetime_count = 0
+
+    def record(self, ms: float):
+        """Add one sample in milliseconds"""
+        bucket = bisect_left(BUCKET_BOUNDS_MS, ms)
+        epoch = int(time.monotonic() / self.slot_seconds)
+        slot = epoch % WINDOW_SLOTS
+        if self._epochs[slot] != epoch:
+            # Slot last used one full window ago - reuse it for this interval
+            self._counts[slot].fill(0)
+            self._max_ms[slot] = 0.0
+            self._epochs[slot] = epoch
+
+        self._counts[slot, bucket] += 1
+        if ms > self._max_ms[slot]:
+            self._max_ms[slot] = ms
+
+        self.lifetime_counts[bucket] += 1
+        self.lifetime_sum_ms += ms
+        self.lifetime_count += 1
+
+    def snapshot(self) -> Dict[str, float]:
+        """
+        Window statistics
+
+        Returns:
+            Dict with count, p50, p90, p99 and max in ms. Percentiles are
+            bucket upper bounds, capped at the observed max.
+        """
+        epoch = int(time.monotonic() / self.slot_seconds)
+        live = [slot for slot, slot_epoch in enumerate(self._epochs) if epoch - slot_epoch < WINDOW_SLOTS]
+        if not live:
+            return {'count': 0, 'p50': 0.0, 'p90': 0.0, 'p99': 0.0, 'max': 0.0}
+
+        counts = self._counts[live].sum(axis=0)
+        cumulative = np.cumsum(counts)
+        total = int(cumulative[-1])
+        max_ms = float(self._max_ms[live].max())
+        if total == 0:
+            return {'count': 0, 'p50': 0.0, 'p90': 0.0, 'p99': 0.0, 'max': 0.0}
+
+        result = {'count': total}
+        for key, quantile in (('p50', 0.50), ('p90', 0.90), ('p99', 0.99)):
+            bucket = int(np.searchsorted(cumulative, quantile * total))
+            bound = BUCKET_BOUNDS_MS[bucket] if bucket < len(BUCKET_BOUNDS_MS) else max_ms
+            result[key] = min(bound, max_ms)
+        result['max'] = max_ms
+        return result
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+Metrics Registry - Named latency histograms and gauges for the whole pipeline
+Renders everything in Prometheus text format and as JSON window summaries
+"""
+
+import threading
+from typing import Callable, Dict, List
+from .histogram import LatencyHistogram, BUCKET_BOUNDS_MS
+
+PREFIX = "mushroom"
+
+
+def _format_labels(labels: Dict[str, str], extra: str = "") -> str:
+    parts = [f'{key}="{value}"' for key, value in labels.items()]
+    if extra:
+        parts.append(extra)
+    return "{" + ",".join(parts) + "}" if parts else ""
+
+
+class MetricsRegistry:
+    """Histograms are created at startup; recording never touches the registry"""
+
+    def __init__(self, window_seconds: float):
+        if window_seconds <= 0:
+            raise ValueError(f"Metrics window must be positive, got {window_seconds}")
+        self.window_seconds = window_seconds
+        self._histograms: Dict[str, List[LatencyHistogram]] = {}
+        self._help: Dict[str, str] = {}
+        self._gauges: List[tuple] = []
+        self._lock = threading.Lock()
+
+    def histogram(self, name: str, description: str, **labels: str) -> LatencyHistogram:
+        """Create and register a histogram; one per recording thread"""
+        histogram = LatencyHistogram(name, labels, self.window_seconds)
+        with self._lock:
+            self._histograms.setdefault(name, []).append(histogram)
+            self._help[name] = description
+        return histogram
+
+    def gauge(self, name: str, description: str, read: Callable[[], float], **labels: str):
+        """Register a value read at export time"""
+        with self._lock:
+            self._gauges.append((name, description, read, labels))
+
+    def summaries(self) -> Dict[str, Dict[str, Dict[str, float]]]:
+        """Window p50/p90/p99/max per histogram, keyed by name then label values"""
+        with self._lock:
+            histograms = {name: list(group) for name, group in self._histograms.items()}
+        result = {}
+        for name, group in histograms.items():
+            result[name] = {
+                ",".join(histogram.labels.values()) or "all": histogram.snapshot()
+                for histogram in group
+            }
+        return result
+
+    def render_prometheus(self) -> str:
+        """Prometheus text exposition: cumulative histograms, window quantiles, gauges"""
+        with self._lock:
+            histograms = {name: list(group) for name, group in self._histograms.items()}
+            gauges = list(self._gauges)
+            help_text = dict(self._help)
+
+        lines = []
+        for name, group in histograms.items():
+            metric = f"{PREFIX}_{name}"
+            lines.append(f"# HELP {metric} {help_text[name]}")
+            lines.append(f"# TYPE {metric} histogram")
+            for histogram in group:
+                labels = _format_labels(histogram.labels)
+                cumulative = 0
+                for bound, count in zip(BUCKET_BOUNDS_MS, histogram.lifetime_counts):
+                    cumulative += int(count)
+                    bucket_labels = _format_labels(histogram.labels, 'le="%.4g"' % bound)
+                    lines.append(f"{metric}_bucket{bucket_labels} {cumulative}")
+                bucket_labels = _format_labels(histogram.labels, 'le="+Inf"')
+                lines.append(f"{metric}_bucket{bucket_labels} {histogram.lifetime_count}")
+                lines.append(f"{metric}_sum{labels} {histogram.lifetime_sum_ms:.6f}")
+                lines.append(f"{metric}_count{labels} {histogram.lifetime_count}")
+
+            window = f"{metric}_window"
+            lines.append(f"# HELP {window} {help_text[name]} over the last {self.window_seconds:g}s")
+            lines.append(f"# TYPE {window} summary")
+            for histogram in group:
+                snapshot = histogram.snapshot()
+                for key, quantile in (('p50', '0.5'), ('p90', '0.9'), ('p99', '0.99')):
+                    quantile_labels = _format_labels(histogram.labels, 'quantile="%s"' % quantile)
+                    lines.append(f"{window}{quantile_labels} {snapshot[key]:.6f}")
+                lines.append(f"{window}_count{_format_labels(histogram.labels)} {snapshot['count']}")
+
+        seen = set()
+        for name, description, read, labels in sorted(gauges, key=lambda gauge: gauge[0]):
+            metric = f"{PREFIX}_{name}"
+            if metric not in seen:
+                lines.append(f"# HELP {metric} {description}")
+                lines.append(f"# TYPE {metric} gauge")
+                seen.add(metric)
+            lines.append(f"{metric}{_format_labels(labels)} {float(read()):.6f}")
+
+        return "\n".join(lines) + "\n"
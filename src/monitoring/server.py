@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""
+Metrics Server - Lightweight HTTP endpoint for pipeline metrics
+GET /metrics returns Prometheus text, GET /metrics.json the summary JSON
+that scripts/display_metrics.py reads
+"""
+
+import json
+import logging
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Callable, Dict, Any
+from .registry import MetricsRegistry
+
+logger = logging.getLogger(__name__)
+
+
+class MetricsServer:
+    """Serves a MetricsRegistry from a daemon thread"""
+
+    def __init__(self, registry: MetricsRegistry, bind: str, port: int,
+                 summary: Callable[[], Dict[str, Any]]):
+        """
+        Args:
+            registry: Histograms and gauges for /metrics
+            bind: Address to listen on (127.0.0.1 keeps it local)
+            port: TCP port
+            summary: Builds the /metrics.json document on each request
+        """
+        self.registry = registry
+        self.summary = summary
+
+        server = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path == '/metrics':
+                    body = server.registry.render_prometheus().encode()
+                    content_type = 'text/plain; version=0.0.4'
+                elif self.path == '/metrics.json':
+                    body = json.dumps(server.summary(), indent=2).encode()
+                    content_type = 'application/json'
+                else:
+                    self.send_error(404)
+                    return
+                self.send_response(200)
+                self.send_header('Content-Type', content_type)
+                self.send_header('Content-Length', str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                logger.debug(f"Metrics request: {format % args}")
+
+        self.httpd = ThreadingHTTPServer((bind, port), Handler)
+        self.httpd.daemon_threads = True
+        self.thread = None
+        logger.info(f"Metrics endpoint on http://{bind}:{port}/metrics")
+
+    def start(self):
+        """Start serving in the background"""
+        self.thread = threading.Thread(target=self.httpd.serve_forever, daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        """Stop serving and close the socket"""
+        if self.thread is not None:
+            self.httpd.shutdown()
+        self.httpd.server_close()
@@ -1,11 +1,15 @@
 # Pattern modules
 from .base import Pattern
 from .registry import PatternRegistry
+from . import kernels
 
-# Import all pattern modules to trigger registration
-# The decorators will automatically register them
-from . import test
-from . import rainbow
+# Pattern modules are imported on first use; the decorators in each one
+# register the class when it loads
+PatternRegistry.declare('test', 'test')
+PatternRegistry.declare('rainbow', 'rainbow')
+PatternRegistry.declare('wisps', 'wisps')
+PatternRegistry.declare('playback', 'playback')
+PatternRegistry.declare('palette', 'palette')
 
 # Export the registry and base class for external use
-__all__ = ['Pattern', 'PatternRegistry']
\ No newline at end of file
+__all__ = ['Pattern', 'PatternRegistry', 'kernels']
\ No newline at end of file
@@ -6,12 +6,22 @@ Base Pattern Class - Abstract base for all LED patterns
 from abc import ABC, abstractmethod
 import numpy as np
 import time
-from typing import Optional, Dict, Any
+from typing import Optional, Dict, Any, Callable, Tuple
+from . import kernels
+from effects.geometry import Geometry
 
 
 class Pattern(ABC):
     """Abstract base class for all LED patterns"""
     
+    # Optional per-pixel kernel, kernel(out, *kernel_args(delta_time)), compiled
+    # by patterns.kernels when enabled; update() stays the NumPy fallback
+    KERNEL: Optional[Callable] = None
+    
+    # Frames can be split into pixel ranges rendered in parallel by the render
+    # pool (see render_tile); each LED's color must depend only on frame state
+    TILEABLE = False
+    
     def __init__(self, led_count: int, fps: float = 30.0):
         # Validate inputs to prevent crashes
         if led_count <= 0:
@@ -23,20 +33,32 @@ class Pattern(ABC):
         self.fps = fps
         self.frame_time = 1.0 / fps
         
-        # Pattern state
+        # Pattern state; now is the timestamp of the frame being rendered
         self.start_time = time.time()
+        self.now = self.start_time
         self.frame_number = 0
         self.last_update = time.time()
         
-        # Output buffer
+        # Output buffer - rebound to the controller's zone view on each render
         self.pixels = np.zeros((led_count, 3), dtype=np.uint8)
         
         # Pattern parameters (can be modified at runtime)
+        # Patterns render at full brightness; the controller's output LUT
+        # applies gamma and global/zone brightness during encoding
         self.params = self.get_default_params()
         
-        # Hardware brightness (0-1), set by controller
-        # Applied during pattern generation to avoid post-processing
-        self.brightness = 1.0
+        # Shared audio analyzer (None when audio is off); read audio.features each frame
+        self.audio = None
+        
+        # Physical LED coordinates; a straight line until the controller binds the strip's layout
+        self.geometry = Geometry.line(led_count)
+        
+        # Render quality 0-1 from the controller's frame budget; below 1 the
+        # pattern may shed work (fewer particles, skipped layers) to hold target_fps
+        self.quality = 1.0
+        
+        self._kernel = kernels.compile_kernel(self.KERNEL) if self.KERNEL is not None else None
+        self._tile_args: Tuple = ()
     
     @abstractmethod
     def get_default_params(self) -> Dict[str, Any]:
@@ -56,17 +78,100 @@ class Pattern(ABC):
         """
         pass
     
-    def render(self) -> np.ndarray:
-        """Generate next frame - called when controller needs new data"""
-        current_time = time.time()
-        delta_time = current_time - self.last_update
+    def kernel_args(self, delta_time: float) -> Tuple:
+        """Arguments after out for KERNEL this frame; static arrays should be cached"""
+        raise NotImplementedError(f"{self.__class__.__name__} defines KERNEL but not kernel_args()")
+    
+    @property
+    def compiled(self) -> bool:
+        """True when frames come from the compiled kernel instead of update()"""
+        return self._kernel is not None
+    
+    def prewarm(self):
+        """Compile the kernel now (first call) instead of on the first live frame"""
+        if self._kernel is not None:
+            self._kernel(self.pixels, *self.kernel_args(0.0))
+    
+    def render(self, out: Optional[np.ndarray] = None, now: Optional[float] = None) -> np.ndarray:
+        """
+        Generate next frame - called when controller needs new data
+        
+        Args:
+            out: (led_count, 3) uint8 view to render into. The controller passes
+                 a view of its shared frame, so patterns writing into self.pixels
+                 in place avoid any copy. Contents from earlier frames are not
+                 preserved between calls.
+            now: Frame timestamp in time.time() seconds (default: the wall
+                 clock). Nested patterns are passed their parent's, and
+                 recorders pass simulated time.
+                 
+        Returns:
+            The array the frame was rendered into
+        """
+        delta_time = self._begin_frame(out, now)
+        out = self.pixels
         
         # Always generate fresh frame - controller handles timing
-        self.pixels = self.update(delta_time)
-        self.last_update = current_time
-        self.frame_number += 1
+        if self._kernel is not None:
+            self._kernel(out, *self.kernel_args(delta_time))
+        else:
+            pixels = self.update(delta_time)
+            if pixels is not out:
+                out[:] = pixels
+        self.end_frame()
+        
+        return out
+    
+    def _begin_frame(self, out: Optional[np.ndarray], now: Optional[float]) -> float:
+        """Bind out and advance the pattern clock; returns delta_time"""
+        if out is None:
+            out = self.pixels
+        elif out.shape != (self.led_count, 3):
+            raise ValueError(f"Output view shape {out.shape} does not match ({self.led_count}, 3)")
+        
+        current_time = time.time() if now is None else now
+        delta_time = current_time - self.last_update
+        self.now = current_time
+        self.pixels = out
+        return delta_time
+    
+    def begin_tiles(self, out: Optional[np.ndarray] = None, now: Optional[float] = None):
+        """
+        Start a tiled frame (TILEABLE patterns): the serial part of render()
         
-        return self.pixels.copy()
+        Follow with render_tile() over ranges covering every LED, from any
+        threads, then end_frame() once all of them have returned.
+        """
+        self.prepare_tiles(self._begin_frame(out, now))
+    
+    def prepare_tiles(self, delta_time: float):
+        """Per-frame state shared by every tile; kernel patterns get their kernel_args() here"""
+        if self._kernel is not None:
+            self._tile_args = self.kernel_args(delta_time)
+    
+    def render_tile(self, start: int, stop: int):
+        """
+        Render pixels[start:stop] of the frame started by begin_tiles()
+        
+        Kernel patterns run the kernel over the range; array arguments with
+        led_count rows are per-LED and sliced to it, anything else is passed
+        whole. NumPy patterns implement update_tile() instead.
+        """
+        if self._kernel is not None:
+            args = tuple(arg[start:stop] if isinstance(arg, np.ndarray) and arg.shape[:1] == (self.led_count,)
+                         else arg for arg in self._tile_args)
+            self._kernel(self.pixels[start:stop], *args)
+        else:
+            self.update_tile(start, stop)
+    
+    def update_tile(self, start: int, stop: int):
+        """NumPy path of render_tile(): write pixels[start:stop] from the state set in prepare_tiles()"""
+        raise NotImplementedError(f"{self.__class__.__name__} is TILEABLE but has no update_tile()")
+    
+    def end_frame(self):
+        """Finish the frame being rendered"""
+        self.last_update = self.now
+        self.frame_number += 1
     
     def set_param(self, name: str, value: Any):
         """Set a pattern parameter"""
@@ -75,17 +180,47 @@ class Pattern(ABC):
         else:
             raise ValueError(f"Unknown parameter '{name}' for pattern. Valid parameters: {list(self.params.keys())}")
     
-    def set_brightness(self, brightness: float):
-        """Set hardware brightness (0-1) for this pattern"""
-        self.brightness = max(0.0, min(1.0, brightness))
+    def bind_audio(self, analyzer):
+        """
+        Attach the shared AudioAnalyzer
+        
+        Patterns read analyzer.features, an immutable snapshot replaced once
+        per analysis hop, so reading it needs no lock and no FFT of their own.
+        """
+        self.audio = analyzer
+    
+    def bind_geometry(self, geometry: Geometry):
+        """
+        Attach the strip's Geometry, shared by every pattern on that strip
+        
+        Coordinates are computed once at startup; patterns that cache arrays
+        derived from them rebuild those in geometry_changed().
+        """
+        if geometry.led_count != self.led_count:
+            raise ValueError(f"Geometry has {geometry.led_count} LEDs but pattern has {self.led_count}")
+        self.geometry = geometry
+        self.geometry_changed()
+    
+    def geometry_changed(self):
+        """Called after bind_geometry(); override to refresh cached coordinate arrays"""
+        pass
+    
+    def set_quality(self, quality: float):
+        """Called after each frame with the zone's current quality (1.0 = full)"""
+        self.quality = quality
     
     def get_time(self) -> float:
-        """Get time since pattern started"""
-        return time.time() - self.start_time
+        """Time since pattern started, at the frame being (or last) rendered"""
+        return self.now - self.start_time
     
     def reset(self):
         """Reset pattern to initial state"""
         self.start_time = time.time()
+        self.now = self.start_time
         self.frame_number = 0
         self.last_update = time.time()
-        self.pixels.fill(0)
\ No newline at end of file
+        self.pixels.fill(0)
+    
+    def close(self):
+        """Release files or mappings held by the pattern; it is not rendered again"""
+        pass
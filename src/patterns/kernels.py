@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Pattern Kernels - Optional compiled per-pixel render functions
+Kernels are plain Python functions over NumPy arrays and scalars, compiled
+with Numba when it is installed and enabled. Compiled kernels release the
+GIL, so cap and stem patterns really do render in parallel. Numba itself is
+imported with the first kernel compiled, so startup does not pay for it.
+"""
+
+import importlib.util
+import logging
+from typing import Callable, Dict, Optional
+
+logger = logging.getLogger(__name__)
+
+AVAILABLE = importlib.util.find_spec('numba') is not None
+
+# Set from performance.compiled_kernels before patterns are created
+_enabled = AVAILABLE
+_compiled: Dict[Callable, Callable] = {}
+# Functions kernels may call (plain -> compiled once numba is loaded)
+_helpers: Dict[Callable, Optional[Callable]] = {}
+_numba = None
+
+
+def configure(enabled: bool):
+    """Turn compiled kernels on or off for patterns created after this call"""
+    global _enabled
+    if enabled and not AVAILABLE:
+        logger.warning("performance.compiled_kernels is on but numba is not installed - using NumPy paths")
+    _enabled = enabled and AVAILABLE
+    logger.info(f"Compiled pattern kernels {'enabled' if _enabled else 'disabled'}")
+
+
+def enabled() -> bool:
+    return _enabled
+
+
+def helper(function: Callable) -> Callable:
+    """Mark a function kernels call; it is compiled (and inlined) with the first kernel"""
+    _helpers[function] = None
+    return function
+
+
+def _load_numba():
+    """Import numba and compile the helpers, once"""
+    global _numba
+    if _numba is None:
+        import numba
+        for function in _helpers:
+            _helpers[function] = numba.njit(cache=True, nogil=True, fastmath=True, inline='always')(function)
+        _numba = numba
+    return _numba
+
+
+def compile_kernel(function: Callable) -> Optional[Callable]:
+    """
+    Compiled version of a kernel, or None when kernels are disabled
+
+    Compilation happens once per process on first call with concrete
+    argument types; cache=True keeps the machine code on disk between runs.
+    """
+    if not _enabled:
+        return None
+    if function not in _compiled:
+        numba = _load_numba()
+        # Kernels call helpers through their module's globals; point those at the compiled versions
+        for name in function.__code__.co_names:
+            value = function.__globals__.get(name)
+            if callable(value) and value in _helpers:
+                function.__globals__[name] = _helpers[value]
+        _compiled[function] = numba.njit(cache=True, nogil=True, fastmath=True)(function)
+    return _compiled[function]
+
+
+@helper
+def hsv_pixel(out, i, hue, saturation, value):
+    """
+    Write one HSV (hue 0-360, saturation/value 0-1) pixel to out[i] as RGB
+
+    Same closed form and rounding as effects.colors.hsv_to_rgb, for use
+    inside kernels; Numba inlines it into the compiled caller.
+    """
+    scaled = value * 255.0
+    chroma = scaled * saturation
+    sector = (hue % 360.0) / 60.0
+    for channel in range(3):
+        k = (sector + (5.0, 3.0, 1.0)[channel]) % 6.0
+        weight = min(k, 4.0 - k)
+        weight = min(max(weight, 0.0), 1.0)
+        out[i, channel] = int(scaled - chroma * weight + 0.5)
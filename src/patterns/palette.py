@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Palette Pattern - A named palette traveling across the mushroom
+Each frame is one gather from the palette's compiled LUT at per-LED
+fixed-point phases; changing the palette param crossfades the LUTs
+"""
+
+import numpy as np
+from typing import Dict, Any
+from .base import Pattern
+from .registry import PatternRegistry
+from effects.palette import PHASE_ONE, Palette, PaletteFade, to_phase
+
+# Geometry coordinate the palette travels along
+MAPPINGS = ('strip', 'height', 'angle', 'radius')
+
+
+@PatternRegistry.register("palette")
+class PaletteWave(Pattern):
+    """Palette that travels along the LED strip, or up, around or out across its geometry"""
+
+    TILEABLE = True
+
+    def __init__(self, led_count: int, fps: float = 30.0):
+        super().__init__(led_count, fps)
+
+        # Fixed-point phase of each LED along the mapping, and gather scratch
+        self._phases = np.zeros(led_count, dtype=np.uint32)
+        self._scratch = np.zeros(led_count, dtype=np.uint32)
+        self._layout = None
+        self._offset = 0
+
+        self._palette_name = self.params['palette']
+        self.fade = PaletteFade(Palette.named(self._palette_name, self.params['lut_size']))
+        self._palette = self.fade.output
+
+    def get_default_params(self) -> Dict[str, Any]:
+        return {
+            'palette': 'mushroom_magic',  # Name in effects.colors.PALETTES
+            'repeat': 1.0,                # Trips through the palette across the mapping
+            'cycle_time': 20.0,           # Seconds for the palette to travel one trip (0 holds still)
+            'mapping': 'strip',           # strip (wire order), height (vertical sweep), angle (around) or radius (outward)
+            'fade_time': 2.0,             # Seconds to crossfade when the palette param changes
+            'lut_size': 256,              # LUT entries: 256, or 1024 for long smooth gradients
+        }
+
+    def _update_phases(self):
+        """Recompute per-LED phases when the mapping or repeat changes"""
+        layout = (self.params['mapping'], float(self.params['repeat']))
+        if layout != self._layout:
+            mapping, repeat = layout
+            if mapping not in MAPPINGS:
+                raise ValueError(f"Unknown palette mapping '{mapping}', expected one of {MAPPINGS}")
+            to_phase(getattr(self.geometry, mapping) * repeat, out=self._phases)
+            self._layout = layout
+
+    def _update_palette(self, delta_time: float):
+        """Start a crossfade on a new palette name and step the running one"""
+        name = self.params['palette']
+        if name != self._palette_name:
+            # Params set before the first frame take effect at once
+            duration = float(self.params['fade_time']) if self.frame_number else 0.0
+            self.fade.fade_to(Palette.named(name, self.fade.output.size), duration)
+            self._palette_name = name
+        self._palette = self.fade.advance(delta_time)
+
+    def geometry_changed(self):
+        self._layout = None
+        self._update_phases()
+
+    def prepare_tiles(self, delta_time: float):
+        super().prepare_tiles(delta_time)
+        self._update_phases()
+        self._update_palette(delta_time)
+        cycle_time = float(self.params['cycle_time'])
+        self._offset = int(self.get_time() / cycle_time * PHASE_ONE) if cycle_time > 0 else 0
+
+    def update_tile(self, start: int, stop: int):
+        self._palette.map(self._phases[start:stop], self._offset,
+                          self.pixels[start:stop], self._scratch[start:stop])
+
+    def update(self, delta_time: float) -> np.ndarray:
+        self.prepare_tiles(delta_time)
+        self.update_tile(0, self.led_count)
+        return self.pixels
+
+    def reset(self):
+        """Restart the cycle and finish any crossfade"""
+        super().reset()
+        self.fade.advance(float('inf'))
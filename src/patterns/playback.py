@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Playback Pattern - Streams a baked frame file instead of computing frames
+Record files with scripts/bake_pattern.py
+"""
+
+import numpy as np
+from typing import Dict, Any, Optional
+from .base import Pattern
+from .registry import PatternRegistry
+from effects.frame_file import FrameFile
+
+
+@PatternRegistry.register("playback")
+class PlaybackPattern(Pattern):
+    """Plays a memory-mapped frame file at its recorded rate, looping by default"""
+
+    def __init__(self, led_count: int, fps: float = 30.0, file: Optional[str] = None):
+        super().__init__(led_count, fps)
+        self.params['file'] = file
+        self.frames: Optional[FrameFile] = None
+        self._file = None
+
+    def get_default_params(self) -> Dict[str, Any]:
+        return {
+            'file': None,    # Frame file path (set_param or the startup layer's params)
+            'speed': 1.0,    # Playback rate multiplier
+            'loop': True,    # Repeat; otherwise hold the last frame
+        }
+
+    def _open(self) -> FrameFile:
+        """Map the configured file, reopening when the file param changes"""
+        path = self.params['file']
+        if path is None:
+            raise ValueError("Playback pattern has no 'file' set")
+        if path != self._file:
+            frames = FrameFile(path)
+            if frames.led_count != self.led_count:
+                raise ValueError(f"{path} holds {frames.led_count} LEDs but zone has {self.led_count}")
+            if self.frames is not None:
+                self.frames.close()
+            self.frames = frames
+            self._file = path
+        return self.frames
+
+    def __getstate__(self):
+        # Sent to a worker process on a live switch: remap there instead of pickling the frames
+        state = self.__dict__.copy()
+        state['frames'] = None
+        state['_file'] = None
+        return state
+
+    def close(self):
+        if self.frames is not None:
+            self.frames.close()
+        self.frames = None
+        self._file = None
+
+    def prewarm(self):
+        """Map the file and fault in the first frame before going live"""
+        self._open().frame(0)
+
+    def update(self, delta_time: float) -> np.ndarray:
+        frames = self._open()
+        index = int(self.get_time() * frames.fps * self.params['speed'])
+        if self.params['loop']:
+            index %= frames.frame_count
+        else:
+            index = min(max(index, 0), frames.frame_count - 1)
+        # The base render copies this into the zone view
+        return frames.frame(index)
@@ -7,39 +7,93 @@ import numpy as np
 from typing import Dict, Any
 from .base import Pattern
 from .registry import PatternRegistry
+from .kernels import hsv_pixel
 from effects.colors import hsv_to_rgb
 
 
+def rainbow_kernel(out, positions, phase, rainbow_count, saturation):
+    """Compiled RainbowWave frame: one fused hue and HSV pass per LED"""
+    for i in range(out.shape[0]):
+        hue = (((positions[i] + phase) * rainbow_count) % 1.0) * 360.0
+        hsv_pixel(out, i, hue, saturation, 1.0)
+
+
+# Geometry coordinate the wave travels along
+MAPPINGS = ('strip', 'height', 'angle', 'radius')
+
+
 @PatternRegistry.register("rainbow")
 class RainbowWave(Pattern):
-    """Rainbow wave that travels along the LED strip"""
+    """Rainbow wave that travels along the LED strip, or up, around or out across its geometry"""
+    
+    KERNEL = staticmethod(rainbow_kernel)
+    TILEABLE = True
+    
+    def __init__(self, led_count: int, fps: float = 30.0):
+        super().__init__(led_count, fps)
+        
+        # Normalized position of each LED (0-1 along the mapping) and hue scratch
+        self._mapping = None
+        self.positions = self._positions()
+        self._hues = np.zeros(led_count, dtype=np.float32)
+        self._frame_phase = 0.0
     
     def get_default_params(self) -> Dict[str, Any]:
         return {
             'rainbow_count': 0.3,   # Number of complete rainbows visible (0.3 = partial rainbow for smooth gradient)
             'cycle_time': 30.0,     # Seconds for pattern to complete one full cycle
             'saturation': 1.0,      # 0-1 color saturation
+            'mapping': 'strip',     # strip (wire order), height (vertical sweep), angle (around) or radius (outward)
         }
     
-    def update(self, delta_time: float) -> np.ndarray:
-        # Calculate phase (0-1) based on time
-        phase = (self.get_time() / self.params['cycle_time']) % 1.0
-        
-        # Create normalized position array (0-1 across strip)
-        positions = np.arange(self.led_count) / self.led_count
-        
-        # Calculate hue for each LED
+    def _positions(self) -> np.ndarray:
+        """Cached geometry coordinate for the current mapping"""
+        mapping = self.params['mapping']
+        if mapping != self._mapping:
+            if mapping not in MAPPINGS:
+                raise ValueError(f"Unknown rainbow mapping '{mapping}', expected one of {MAPPINGS}")
+            self.positions = getattr(self.geometry, mapping)
+            self._mapping = mapping
+        return self.positions
+    
+    def geometry_changed(self):
+        self._mapping = None
+        self._positions()
+    
+    def phase(self) -> float:
+        """Pattern phase (0-1) based on time"""
+        return (self.get_time() / self.params['cycle_time']) % 1.0
+    
+    def kernel_args(self, delta_time: float):
+        saturation = min(max(float(self.params['saturation']), 0.0), 1.0)
+        return (self._positions(), self.phase(), float(self.params['rainbow_count']), saturation)
+    
+    def prepare_tiles(self, delta_time: float):
+        super().prepare_tiles(delta_time)
+        self._positions()
+        self._frame_phase = self.phase()
+    
+    def update_tile(self, start: int, stop: int):
+        # Calculate hue for each LED in place
         # rainbow_count controls how many rainbows fit across the strip
         # phase shifts the pattern over time
-        hues = (((positions + phase) * self.params['rainbow_count']) % 1.0) * 360
+        hues = self._hues[start:stop]
+        np.add(self.positions[start:stop], self._frame_phase, out=hues)
+        hues *= self.params['rainbow_count']
+        np.mod(hues, 1.0, out=hues)
+        hues *= 360.0
         
-        # Convert HSV to RGB with hardware brightness applied
-        self.pixels = hsv_to_rgb(
+        # Convert HSV to RGB straight into the zone view
+        hsv_to_rgb(
             hues, 
             self.params['saturation'], 
-            self.brightness
+            1.0,
+            out=self.pixels[start:stop]
         )
-        
+    
+    def update(self, delta_time: float) -> np.ndarray:
+        self.prepare_tiles(delta_time)
+        self.update_tile(0, self.led_count)
         return self.pixels
 
 
@@ -1,9 +1,13 @@
 #!/usr/bin/env python3
 """
 Pattern Registry - Dynamic pattern registration and management
+Pattern modules are declared by name and imported on first use, so startup
+only loads the patterns (and their dependencies) that are actually shown
 """
 
+import importlib
 import logging
+import sys
 from typing import Dict, Type, Optional, List
 from .base import Pattern
 
@@ -15,6 +19,8 @@ class PatternRegistry:
     
     _instance = None
     _patterns: Dict[str, Type[Pattern]] = {}
+    # Pattern name -> module in this package that registers it when imported
+    _modules: Dict[str, str] = {}
     
     def __new__(cls):
         """Singleton pattern to ensure one registry"""
@@ -53,9 +59,27 @@ class PatternRegistry:
         
         return decorator
     
+    @classmethod
+    def declare(cls, name: str, module: str):
+        """Name a pattern whose module (within patterns) is imported on first use"""
+        cls._modules[name] = module
+    
+    @classmethod
+    def _load(cls, name: str):
+        if name not in cls._patterns and name in cls._modules:
+            module = f"{__package__}.{cls._modules[name]}"
+            if module in sys.modules:
+                # Imported before a clear(): run it again so it registers again
+                importlib.reload(sys.modules[module])
+            else:
+                importlib.import_module(module)
+            if name not in cls._patterns:
+                raise RuntimeError(f"Module '{cls._modules[name]}' did not register pattern '{name}'")
+    
     @classmethod
     def get_pattern(cls, name: str) -> Optional[Type[Pattern]]:
-        """Get a pattern class by name"""
+        """Get a pattern class by name, importing its module if needed"""
+        cls._load(name)
         return cls._patterns.get(name)
     
     @classmethod
@@ -70,17 +94,24 @@ class PatternRegistry:
     
     @classmethod
     def list_patterns(cls) -> List[str]:
-        """Get list of all registered pattern names"""
-        return list(cls._patterns.keys())
+        """Get list of all pattern names, declared or registered (imports nothing)"""
+        return list(dict.fromkeys(list(cls._modules) + list(cls._patterns)))
     
     @classmethod
     def get_all_patterns(cls) -> Dict[str, Type[Pattern]]:
-        """Get all registered patterns"""
+        """Get all patterns, importing every declared module"""
+        for name in cls._modules:
+            cls._load(name)
         return cls._patterns.copy()
     
     @classmethod
     def clear(cls):
-        """Clear all registered patterns (mainly for testing)"""
+        """
+        Clear all registered patterns (mainly for testing)
+        
+        Declarations are kept: a declared pattern is registered again on next
+        use by reloading its module, which creates new classes.
+        """
         cls._patterns.clear()
 
 
@@ -37,28 +37,22 @@ class TestPattern(Pattern):
         phase = elapsed % total_cycle
         step = int(phase / step_time)
         
-        # Apply brightness to all colors
         if step == 0:  # Red
-            self.pixels[:] = [255 * self.brightness, 0, 0]
+            self.pixels[:] = [255, 0, 0]
         elif step == 1:  # Green
-            self.pixels[:] = [0, 255 * self.brightness, 0]
+            self.pixels[:] = [0, 255, 0]
         elif step == 2:  # Blue
-            self.pixels[:] = [0, 0, 255 * self.brightness]
+            self.pixels[:] = [0, 0, 255]
         elif step == 3:  # White 20%
-            level = int(51 * self.brightness)
-            self.pixels[:] = [level, level, level]
+            self.pixels[:] = [51, 51, 51]
         elif step == 4:  # White 40%
-            level = int(102 * self.brightness)
-            self.pixels[:] = [level, level, level]
+            self.pixels[:] = [102, 102, 102]
         elif step == 5:  # White 60%
-            level = int(153 * self.brightness)
-            self.pixels[:] = [level, level, level]
+            self.pixels[:] = [153, 153, 153]
         elif step == 6:  # White 80%
-            level = int(204 * self.brightness)
-            self.pixels[:] = [level, level, level]
+            self.pixels[:] = [204, 204, 204]
         elif step == 7:  # White 100%
-            level = int(255 * self.brightness)
-            self.pixels[:] = [level, level, level]
+            self.pixels[:] = [255, 255, 255]
         else:
             raise RuntimeError(f"Test pattern logic error: invalid step {step}")
         
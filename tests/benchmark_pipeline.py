@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""
+Pipeline benchmark - LEDController end-to-end against the virtual SPI backend
+Sweeps LED counts, patterns, thread layouts and execution modes and prints JSON results
+
+Usage:
+    python3 tests/benchmark_pipeline.py
+    python3 tests/benchmark_pipeline.py --led-counts 700,5000 --patterns rainbow --duration 10 -o bench.json
+    python3 tests/benchmark_pipeline.py --frame-file shows/rainbow.mshf   # Same baked input on every zone
+    python3 tests/benchmark_pipeline.py --zones 2,6 --execution threads,processes   # Render pool scaling
+    python3 tests/benchmark_pipeline.py --zones 1 --led-counts 5000 --patterns rainbow --tile-leds 0   # Untiled baseline
+"""
+
+import argparse
+import copy
+import itertools
+import json
+import logging
+import os
+import platform
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+import yaml
+
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from effects.frame_file import FrameFile
+from hardware.led_controller import LEDController
+from patterns import PatternRegistry, kernels
+
+BASE_CONFIG = Path(__file__).parent.parent / 'config' / 'led_config.yaml'
+DEFAULT_LED_COUNTS = [50, 700, 2000, 5000]
+LAYOUTS = ['single', 'split']   # One chain, or alternate zones on a second bus
+THREAD_MODES = ['default', 'pinned']
+EXECUTION_MODES = ['threads', 'processes']
+WARMUP_SECONDS = 1.0
+
+
+def build_config(base: dict, led_count: int, zones: int, layout: str, streaming: bool, threads: str,
+                 execution: str, duration: float) -> dict:
+    """Benchmark variant of the deployed config, with led_count split evenly over zones"""
+    config = copy.deepcopy(base)
+    config['strips'] = [
+        {'id': f'zone{index}', 'led_count': led_count * (index + 1) // zones - led_count * index // zones}
+        for index in range(zones)
+    ]
+    if layout == 'split':
+        for strip in config['strips'][1::2]:
+            strip['spi_device'] = '/dev/virtual1'
+
+    config['hardware']['spi_backend'] = 'virtual'
+    config['hardware']['spi_streaming'] = streaming
+    # Resend every frame so static patterns still measure the full encode and wire cost
+    config['timing']['keepalive_interval_s'] = 1e-9
+    config['timing']['metrics_window_seconds'] = duration + WARMUP_SECONDS
+    config['performance']['execution'] = execution
+
+    thread_config = config['performance']['threads']
+    thread_config['lock_memory'] = False
+    if threads == 'default':
+        every_cpu = list(range(os.cpu_count()))
+        for name in ('spi', 'pattern', 'audio'):
+            thread_config[name] = {'cpus': every_cpu, 'policy': 'other', 'priority': 0}
+    return config
+
+
+def cpu_seconds(controller: LEDController) -> float:
+    """CPU time of this process plus any pattern worker processes"""
+    total = time.process_time()
+    for zone in controller.zones.values():
+        process = getattr(zone.buffer, 'process', None)
+        if process is None:
+            continue
+        with open(f'/proc/{process.pid}/stat', 'r') as f:
+            # utime and stime, after the parenthesised command name
+            fields = f.read().rsplit(')', 1)[1].split()
+        total += (int(fields[11]) + int(fields[12])) / os.sysconf('SC_CLK_TCK')
+    return total
+
+
+def run_case(config: dict, pattern_name: str, duration: float, frame_file: str = None) -> dict:
+    """Run one configuration and measure it"""
+    with tempfile.NamedTemporaryFile('w', suffix='.yaml', delete=False) as f:
+        yaml.safe_dump(config, f)
+        config_path = f.name
+
+    try:
+        controller = LEDController(config_path)
+    finally:
+        os.unlink(config_path)
+
+    # As main.py: kernels follow the config, and compile before the clock starts
+    kernels.configure(config['performance']['compiled_kernels'])
+    registry = PatternRegistry()
+    for name, zone in controller.zones.items():
+        pattern = registry.create_pattern(pattern_name, zone.led_count)
+        if frame_file:
+            pattern.set_param('file', frame_file)
+        pattern.bind_geometry(zone.geometry)
+        pattern.prewarm()
+        controller.set_pattern(name, pattern)
+
+    try:
+        controller.start()
+        time.sleep(WARMUP_SECONDS)
+
+        frames_start = controller.chains[0].transmitter.frames_sent
+        wall_start = time.perf_counter()
+        cpu_start = cpu_seconds(controller)
+        time.sleep(duration)
+        wall = time.perf_counter() - wall_start
+        cpu = cpu_seconds(controller) - cpu_start
+        frames = controller.chains[0].transmitter.frames_sent - frames_start
+
+        stats = controller.get_stats()
+        return {
+            'fps': frames / wall,
+            'cpu_percent': cpu / wall * 100,
+            'frames': frames,
+            'bytes_per_frame': sum(chain.transmitter.total_bytes for chain in controller.chains),
+            'wire_ms': max(chain.transmitter.wire_seconds for chain in controller.chains) * 1000,
+            'dropped': sum(zone['dropped'] for zone in stats['zones'].values()),
+            'errors': stats['errors'],
+            'latency_ms': controller.metrics.summaries(),
+        }
+    finally:
+        controller.cleanup()
+
+
+def parse_list(value: str) -> list:
+    return [item.strip() for item in value.split(',') if item.strip()]
+
+
+def main():
+    available = PatternRegistry().list_patterns()
+    # playback only has frames to play with --frame-file
+    generated = [name for name in available if name != 'playback']
+
+    parser = argparse.ArgumentParser(description='Benchmark the LED pipeline on the virtual SPI backend')
+    parser.add_argument('--led-counts', default=','.join(map(str, DEFAULT_LED_COUNTS)),
+                        help='Comma-separated total LED counts')
+    parser.add_argument('--patterns', default=','.join(generated),
+                        help=f'Comma-separated patterns (available: {", ".join(generated)})')
+    parser.add_argument('--zones', default='2', help='Comma-separated zone counts')
+    parser.add_argument('--tile-leds', type=int, default=None,
+                        help='Override performance.tile_leds (0 renders every zone whole)')
+    parser.add_argument('--layouts', default=','.join(LAYOUTS), help='single and/or split')
+    parser.add_argument('--streaming', default='off', help='off, on or off,on')
+    parser.add_argument('--threads', default='default',
+                        help='default (no pinning) and/or pinned (performance.threads from the config)')
+    parser.add_argument('--execution', default='threads',
+                        help='threads and/or processes (performance.execution)')
+    parser.add_argument('--duration', type=float, default=5.0, help='Measured seconds per case')
+    parser.add_argument('--frame-file', default=None,
+                        help='Play this baked frame file on every zone (overrides --patterns and --led-counts)')
+    parser.add_argument('--output', '-o', default=None, help='Write JSON here instead of stdout')
+    args = parser.parse_args()
+
+    led_counts = [int(count) for count in parse_list(args.led_counts)]
+    patterns = parse_list(args.patterns)
+    zone_counts = [int(count) for count in parse_list(args.zones)]
+    layouts = parse_list(args.layouts)
+    streaming_modes = [mode == 'on' for mode in parse_list(args.streaming)]
+    thread_modes = parse_list(args.threads)
+    execution_modes = parse_list(args.execution)
+    # (total LEDs, zones) per case
+    sizes = [(count, zones) for count in led_counts for zones in zone_counts]
+    if args.frame_file:
+        # Reproducible input: every zone sized to the recording
+        patterns = ['playback']
+        sizes = [(zones * FrameFile(args.frame_file).led_count, zones) for zones in zone_counts]
+
+    for pattern in patterns:
+        if pattern not in available:
+            parser.error(f"Unknown pattern '{pattern}'")
+        if pattern == 'playback' and not args.frame_file:
+            parser.error("The playback pattern needs --frame-file")
+    for layout in layouts:
+        if layout not in LAYOUTS:
+            parser.error(f"Unknown layout '{layout}'")
+    for mode in thread_modes:
+        if mode not in THREAD_MODES:
+            parser.error(f"Unknown thread mode '{mode}'")
+    for mode in execution_modes:
+        if mode not in EXECUTION_MODES:
+            parser.error(f"Unknown execution mode '{mode}'")
+    if any(zones < 1 for zones in zone_counts):
+        parser.error("Zone counts must be at least 1")
+    if any(count < zones for count, zones in sizes):
+        parser.error("LED counts must be at least the zone count")
+
+    # Keep stdout clean for the JSON document
+    logging.basicConfig(level=logging.WARNING, stream=sys.stderr,
+                        format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+
+    with open(BASE_CONFIG, 'r') as f:
+        base = yaml.safe_load(f)
+    if args.tile_leds is not None:
+        base['performance']['tile_leds'] = args.tile_leds
+
+    results = []
+    cases = list(itertools.product(sizes, patterns, layouts, streaming_modes, thread_modes,
+                                   execution_modes))
+    for index, ((led_count, zones), pattern, layout, streaming, threads, execution) in enumerate(cases, 1):
+        print(f"[{index}/{len(cases)}] {led_count} LEDs in {zones} zones, {pattern}, {layout}, "
+              f"streaming={'on' if streaming else 'off'}, threads={threads}, execution={execution}",
+              file=sys.stderr)
+        config = build_config(base, led_count, zones, layout, streaming, threads, execution, args.duration)
+        result = run_case(config, pattern, args.duration, args.frame_file)
+        result.update({
+            'led_count': led_count,
+            'zones': zones,
+            'pattern': pattern,
+            'layout': layout,
+            'streaming': streaming,
+            'threads': threads,
+            'execution': execution,
+        })
+        results.append(result)
+        print(f"    {result['fps']:.1f} FPS, {result['cpu_percent']:.0f}% CPU", file=sys.stderr)
+
+    document = {
+        'timestamp': time.time(),
+        'host': {
+            'platform': platform.platform(),
+            'machine': platform.machine(),
+            'python': platform.python_version(),
+            'cpu_count': os.cpu_count(),
+        },
+        'duration_seconds': args.duration,
+        'results': results,
+    }
+
+    output = json.dumps(document, indent=2)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(output + '\n')
+    else:
+        print(output)
+
+
+if __name__ == '__main__':
+    main()
@@ -114,7 +114,8 @@ def test_audio_capture(device_id: int = None):
     # Configure audio stream
     config = {
         'sample_rate': 44100,
-        'buffer_size': 512,
+        'buffer_size': 64,
+        'ring_seconds': 1.0,
         'device_id': device_id
     }
     
@@ -184,6 +185,7 @@ def test_audio_capture(device_id: int = None):
         print(f"  Total frames: {final_status.frames_read}")
         print(f"  Uptime: {final_status.uptime:.1f} seconds")
         print(f"  Average sample rate: {final_status.frames_read/final_status.uptime:.0f} Hz")
+        print(f"  Input overflows: {final_status.input_overflows}")
     
     return True
 
@@ -0,0 +1,355 @@
+#!/usr/bin/env python3
+"""
+Pattern replay test - Golden output hashes, frame-time budgets and per-frame allocations
+Renders every registered pattern on a virtual clock with seeded random
+generators, so its frames are reproducible, and checks them against recorded
+hashes; then times render() per frame across LED counts and fails any
+pattern slower than the frame budget at the deployed LED count
+
+Usage:
+    python3 tests/test_pattern_replay.py                          # Check against tests/golden/pattern_replay.json
+    python3 tests/test_pattern_replay.py --record                 # Accept the current output as golden
+    python3 tests/test_pattern_replay.py --patterns rainbow,palette --led-counts 700 -o replay.json
+    python3 tests/test_pattern_replay.py --max-temp-kb 0          # Fail any pattern that allocates per frame
+
+Record on the deployment image: hashes depend on the NumPy build and on
+whether kernels are compiled. The committed file covers the patterns whose
+frames are exact integer arithmetic (palette, test); a missing golden file
+fails unless --record. Exits 1 on any failure.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import platform
+import random
+import sys
+import tempfile
+import time
+import tracemalloc
+from pathlib import Path
+
+import numpy as np
+import yaml
+
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from effects.frame_file import bake_pattern
+from patterns import Pattern, PatternRegistry, kernels
+
+BASE_CONFIG = Path(__file__).parent.parent / 'config' / 'led_config.yaml'
+GOLDEN = Path(__file__).parent / 'golden' / 'pattern_replay.json'
+DEFAULT_LED_COUNTS = [50, 700, 2000]
+BUDGET_LEDS = 700                   # Cap plus stem
+VIRTUAL_EPOCH = 1_000_000.0         # Pattern clock start, in place of time.time()
+CHECKPOINT_FRAMES = 10              # Golden running hash every this many frames
+ALLOC_TOLERANCE_BYTES = 1024        # Per-frame temporaries below this are not flagged
+
+
+def playback_params(led_count: int, frames: int, fps: float, workdir: str) -> dict:
+    """Playback needs a file: bake rainbow at the same size"""
+    path = os.path.join(workdir, f'rainbow_{led_count}.mshf')
+    if not os.path.exists(path):
+        source = PatternRegistry.create_pattern('rainbow', led_count, fps=fps)
+        bake_pattern(source, path, frames / fps, fps)
+    return {'file': path}
+
+
+# Params a pattern needs to render at all, by name
+CASE_PARAMS = {
+    'playback': playback_params,
+}
+
+
+def reachable(root):
+    """Objects in a pattern's state (nested patterns, particle systems), following repo types only"""
+    seen = set()
+    stack = [root]
+    while stack:
+        obj = stack.pop()
+        if id(obj) in seen:
+            continue
+        seen.add(id(obj))
+        yield obj
+        if isinstance(obj, (list, tuple)):
+            stack.extend(obj)
+        elif isinstance(obj, dict):
+            stack.extend(obj.values())
+        elif type(obj).__module__.split('.')[0] in ('patterns', 'effects') and hasattr(obj, '__dict__'):
+            stack.extend(vars(obj).values())
+
+
+def start_clock(pattern: Pattern, seed: int):
+    """
+    Reset pattern (and any nested ones) onto the virtual clock with seeded RNGs
+
+    Frames are then rendered with explicit timestamps, which get_time() reads,
+    so nothing depends on the wall clock.
+    """
+    pattern.reset()
+    random.seed(seed)
+    np.random.seed(seed)
+    generators = 0
+    for obj in list(reachable(pattern)):
+        if isinstance(obj, Pattern):
+            obj.start_time = obj.now = obj.last_update = VIRTUAL_EPOCH
+        if hasattr(obj, '__dict__') and not isinstance(obj, type):
+            for name, value in list(vars(obj).items()):
+                if isinstance(value, np.random.Generator):
+                    setattr(obj, name, np.random.default_rng([seed, generators]))
+                    generators += 1
+
+
+def frame_time(index: int, fps: float) -> float:
+    return VIRTUAL_EPOCH + index / fps
+
+
+def build(name: str, led_count: int, frames: int, fps: float, seed: int, workdir: str) -> Pattern:
+    """Pattern with its case params, kernel compiled, on the virtual clock"""
+    pattern = PatternRegistry.create_pattern(name, led_count, fps=fps)
+    if pattern is None:
+        raise ValueError(f"Pattern '{name}' could not be created")
+    if name in CASE_PARAMS:
+        for param, value in CASE_PARAMS[name](led_count, frames, fps, workdir).items():
+            pattern.set_param(param, value)
+    pattern.prewarm()
+    start_clock(pattern, seed)
+    return pattern
+
+
+def replay(pattern: Pattern, frames: int, fps: float, tiles: int = 1) -> dict:
+    """
+    Render frames and hash them
+
+    tiles > 1 renders each frame in that many uneven pixel ranges, as the
+    render pool does, which must not change the output.
+    """
+    frame = np.zeros((pattern.led_count, 3), dtype=np.uint8)
+    digest = hashlib.sha256()
+    checkpoints = []
+    bounds = [pattern.led_count * index * index // (tiles * tiles) for index in range(tiles + 1)]
+    for index in range(frames):
+        if tiles > 1:
+            pattern.begin_tiles(frame, frame_time(index, fps))
+            for start, stop in zip(bounds, bounds[1:]):
+                if stop > start:
+                    pattern.render_tile(start, stop)
+            pattern.end_frame()
+        else:
+            pattern.render(frame, frame_time(index, fps))
+        digest.update(frame.tobytes())
+        if (index + 1) % CHECKPOINT_FRAMES == 0:
+            checkpoints.append(digest.hexdigest()[:16])
+    return {'sha256': digest.hexdigest(), 'checkpoints': checkpoints}
+
+
+def time_frames(pattern: Pattern, frames: int, fps: float, offset: int) -> dict:
+    """Wall time of render() (update() or the kernel) per frame, in ms"""
+    frame = np.zeros((pattern.led_count, 3), dtype=np.uint8)
+    samples = np.empty(frames)
+    for index in range(frames):
+        now = frame_time(offset + index, fps)
+        started = time.perf_counter()
+        pattern.render(frame, now)
+        samples[index] = time.perf_counter() - started
+    samples *= 1000
+    return {
+        'median_ms': float(np.median(samples)),
+        'p95_ms': float(np.percentile(samples, 95)),
+        'max_ms': float(samples.max()),
+    }
+
+
+def measure_allocations(pattern: Pattern, frames: int, fps: float, offset: int) -> dict:
+    """Peak temporary memory per frame (NumPy buffers included) and frames that allocated"""
+    frame = np.zeros((pattern.led_count, 3), dtype=np.uint8)
+    tracemalloc.start()
+    try:
+        peak_bytes = 0
+        allocating = 0
+        for index in range(frames):
+            tracemalloc.reset_peak()
+            before, _ = tracemalloc.get_traced_memory()
+            pattern.render(frame, frame_time(offset + index, fps))
+            _, peak = tracemalloc.get_traced_memory()
+            temporaries = peak - before
+            peak_bytes = max(peak_bytes, temporaries)
+            if temporaries > ALLOC_TOLERANCE_BYTES:
+                allocating += 1
+    finally:
+        tracemalloc.stop()
+    return {'temp_kb': peak_bytes / 1024, 'allocating_frames': allocating}
+
+
+def first_divergence(expected: list, actual: list) -> str:
+    for index, (want, got) in enumerate(zip(expected, actual)):
+        if want != got:
+            return f"by frame {(index + 1) * CHECKPOINT_FRAMES}"
+    return "after the last checkpoint"
+
+
+def run_case(name: str, led_count: int, args, golden: dict, workdir: str) -> dict:
+    """Replay, compare, time and measure one pattern at one LED count"""
+    key = f"{name}@{led_count}"
+    result = {'case': key, 'failures': [], 'warnings': []}
+    try:
+        pattern = build(name, led_count, args.frames, args.fps, args.seed, workdir)
+        output = replay(pattern, args.frames, args.fps)
+        result.update(output)
+        result['compiled'] = pattern.compiled
+
+        # Unseeded randomness or wall-clock reads show up as a second run differing
+        again = build(name, led_count, args.frames, args.fps, args.seed, workdir)
+        if replay(again, args.frames, args.fps)['sha256'] != output['sha256']:
+            result['failures'].append("output differs between identical runs (wall clock or unseeded RNG?)")
+        if pattern.TILEABLE and led_count >= 3:
+            tiled = build(name, led_count, args.frames, args.fps, args.seed, workdir)
+            if replay(tiled, args.frames, args.fps, tiles=3)['sha256'] != output['sha256']:
+                result['failures'].append("tiled rendering differs from whole frames")
+
+        if key not in golden['cases']:
+            result['golden'] = 'new'
+            if not args.record:
+                result['warnings'].append("no golden hash recorded (--record to add)")
+        else:
+            recorded = golden['cases'][key]
+            if recorded['compiled'] != pattern.compiled:
+                result['golden'] = 'skipped'
+                result['warnings'].append(f"golden recorded with compiled={recorded['compiled']}")
+            elif recorded['sha256'] == output['sha256']:
+                result['golden'] = 'match'
+            else:
+                result['golden'] = 'changed'
+                where = first_divergence(recorded['checkpoints'], output['checkpoints'])
+                # Recording accepts the change
+                (result['warnings'] if args.record else result['failures']).append(
+                    f"output changed {where} (--record if intended)")
+
+        result.update(time_frames(pattern, args.timing_frames, args.fps, args.frames))
+        if led_count == args.budget_leds and result['p95_ms'] > args.budget_ms:
+            result['failures'].append(f"p95 {result['p95_ms']:.2f} ms over the {args.budget_ms:.1f} ms budget")
+
+        result.update(measure_allocations(pattern, args.alloc_frames, args.fps, args.frames + args.timing_frames))
+        if result['allocating_frames']:
+            message = (f"{result['allocating_frames']}/{args.alloc_frames} frames allocate, "
+                       f"up to {result['temp_kb']:.1f} KB")
+            if args.max_temp_kb is not None and result['temp_kb'] > args.max_temp_kb:
+                result['failures'].append(message)
+            else:
+                result['warnings'].append(message)
+    except Exception as e:
+        result['failures'].append(f"{type(e).__name__}: {e}")
+    return result
+
+
+def load_golden(path: Path, args) -> dict:
+    """Recorded hashes; the replay settings must match the ones they were recorded with"""
+    settings = {'frames': args.frames, 'fps': args.fps, 'seed': args.seed}
+    if not path.exists():
+        if not args.record:
+            raise SystemExit(f"No golden hashes at {path} (--record to create them)")
+        return {'settings': settings, 'cases': {}}
+    with open(path, 'r') as f:
+        golden = json.load(f)
+    if golden['settings'] != settings:
+        if not args.record:
+            raise SystemExit(f"{path} was recorded with {golden['settings']}, not {settings}")
+        # Hashes from other settings are not comparable; record them all afresh
+        golden = {'settings': settings, 'cases': {}}
+    return golden
+
+
+def record(path: Path, golden: dict, results: list):
+    for result in results:
+        if 'sha256' in result:
+            golden['cases'][result['case']] = {
+                'compiled': result['compiled'],
+                'sha256': result['sha256'],
+                'checkpoints': result['checkpoints'],
+            }
+    golden['recorded_with'] = {
+        'python': platform.python_version(),
+        'numpy': np.__version__,
+        'machine': platform.machine(),
+    }
+    golden['cases'] = dict(sorted(golden['cases'].items()))
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, 'w') as f:
+        json.dump(golden, f, indent=2)
+        f.write('\n')
+
+
+def parse_list(value: str) -> list:
+    return [item.strip() for item in value.split(',') if item.strip()]
+
+
+def main():
+    available = PatternRegistry().list_patterns()
+    with open(BASE_CONFIG, 'r') as f:
+        target_fps = yaml.safe_load(f)['performance']['target_fps']
+
+    parser = argparse.ArgumentParser(description='Replay patterns against golden hashes and frame budgets')
+    parser.add_argument('--patterns', default=','.join(available),
+                        help=f'Comma-separated patterns (available: {", ".join(available)})')
+    parser.add_argument('--led-counts', default=','.join(map(str, DEFAULT_LED_COUNTS)),
+                        help='Comma-separated LED counts')
+    parser.add_argument('--frames', type=int, default=120, help='Frames replayed and hashed per case')
+    parser.add_argument('--fps', type=float, default=60.0, help='Virtual frame rate of the replay')
+    parser.add_argument('--seed', type=int, default=1234, help='Seed for every random generator')
+    parser.add_argument('--timing-frames', type=int, default=300, help='Frames timed per case')
+    parser.add_argument('--alloc-frames', type=int, default=60, help='Frames traced for allocations per case')
+    parser.add_argument('--budget-ms', type=float, default=1000.0 / target_fps,
+                        help='Frame budget for render() p95 (default: 1 / performance.target_fps)')
+    parser.add_argument('--budget-leds', type=int, default=BUDGET_LEDS, help='LED count the budget applies to')
+    parser.add_argument('--max-temp-kb', type=float, default=None,
+                        help='Fail patterns whose per-frame temporaries exceed this (default: warn only)')
+    parser.add_argument('--no-kernels', action='store_true', help='Replay the NumPy paths (compiled_kernels off)')
+    parser.add_argument('--golden', default=str(GOLDEN), help='Golden hash file')
+    parser.add_argument('--record', action='store_true', help='Write the current output hashes as golden')
+    parser.add_argument('--output', '-o', default=None, help='Also write the results as JSON')
+    args = parser.parse_args()
+
+    patterns = parse_list(args.patterns)
+    led_counts = [int(count) for count in parse_list(args.led_counts)]
+    for pattern in patterns:
+        if pattern not in available:
+            parser.error(f"Unknown pattern '{pattern}'")
+    if args.frames < CHECKPOINT_FRAMES:
+        parser.error(f"--frames must be at least {CHECKPOINT_FRAMES}")
+    kernels.configure(not args.no_kernels)
+
+    golden_path = Path(args.golden)
+    golden = load_golden(golden_path, args)
+    results = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for led_count in led_counts:
+            for name in patterns:
+                result = run_case(name, led_count, args, golden, workdir)
+                results.append(result)
+                timing = (f"{result['median_ms']:7.3f} / {result['p95_ms']:7.3f} ms"
+                          if 'p95_ms' in result else ' ' * 20)
+                status = 'FAIL' if result['failures'] else 'ok'
+                golden_status = result['golden'] if 'golden' in result else '-'
+                print(f"{result['case']:<20} {golden_status:<8} {timing}  {status}")
+                for message in result['failures']:
+                    print(f"    FAIL  {message}")
+                for message in result['warnings']:
+                    print(f"    WARN  {message}")
+
+    if args.record:
+        record(golden_path, golden, results)
+        print(f"Recorded {sum('sha256' in result for result in results)} cases to {golden_path}")
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2)
+
+    failed = [result['case'] for result in results if result['failures']]
+    if failed:
+        print(f"\n{len(failed)} of {len(results)} cases failed: {', '.join(failed)}")
+        sys.exit(1)
+    print(f"\nAll {len(results)} cases passed (budget {args.budget_ms:.1f} ms at {args.budget_leds} LEDs)")
+
+
+if __name__ == '__main__':
+    main()